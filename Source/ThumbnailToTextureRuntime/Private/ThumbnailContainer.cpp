@@ -0,0 +1,149 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailContainer.h"
+
+#include "IImageWrapperModule.h"
+#include "ImageCore.h"
+#include "Algo/BinarySearch.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Hash/CityHash.h"
+#include "Misc/FileHelper.h"
+#include "Modules/ModuleManager.h"
+
+namespace ThumbnailContainer
+{
+	/** Entries of a format written by a newer version are skipped */
+	bool IsKnownFormat(uint8 Format)
+	{
+		return Format <= static_cast<uint8>(EThumbnailContainerEntryFormat::JPEG);
+	}
+}
+
+uint64 ThumbnailContainer::HashAssetPath(FStringView AssetPath)
+{
+	const FString LowerPath = FString(AssetPath).ToLower();
+	const FTCHARToUTF8 Utf8Path(*LowerPath);
+	return CityHash64(reinterpret_cast<const char*>(Utf8Path.Get()), Utf8Path.Length());
+}
+
+FThumbnailContainerReader::FThumbnailContainerReader()
+	: Data(nullptr)
+	, DataSize(0)
+{
+}
+
+FThumbnailContainerReader::~FThumbnailContainerReader()
+{
+	Close();
+}
+
+bool FThumbnailContainerReader::Open(const FString& Filename)
+{
+	Close();
+
+	// Mapping only reads the pages that are touched, the trailer and the index pages a lookup goes through
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (MappedFile.IsValid() && MappedFile->GetFileSize() > 0)
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	}
+
+	if (MappedRegion.IsValid())
+	{
+		Data = MappedRegion->GetMappedPtr();
+		DataSize = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		MappedFile.Reset();
+		if (!FFileHelper::LoadFileToArray(LoadedFile, *Filename, FILEREAD_Silent))
+		{
+			return false;
+		}
+		Data = LoadedFile.GetData();
+		DataSize = LoadedFile.Num();
+	}
+
+	FThumbnailContainerTrailer Trailer;
+	if (DataSize >= static_cast<int64>(sizeof(Trailer)))
+	{
+		FMemory::Memcpy(&Trailer, Data + DataSize - sizeof(Trailer), sizeof(Trailer));
+	}
+
+	const uint64 IndexSize = static_cast<uint64>(Trailer.NumEntries) * sizeof(FThumbnailContainerIndexEntry);
+	if (DataSize < static_cast<int64>(sizeof(Trailer))
+		|| Trailer.Magic != ThumbnailContainer::Magic
+		|| Trailer.Version != ThumbnailContainer::Version
+		|| Trailer.IndexOffset % ThumbnailContainer::Alignment != 0
+		|| Trailer.IndexOffset + IndexSize + sizeof(Trailer) != static_cast<uint64>(DataSize))
+	{
+		Close();
+		return false;
+	}
+
+	Index = MakeArrayView(reinterpret_cast<const FThumbnailContainerIndexEntry*>(Data + Trailer.IndexOffset), Trailer.NumEntries);
+	return true;
+}
+
+void FThumbnailContainerReader::Close()
+{
+	Index = TArrayView<const FThumbnailContainerIndexEntry>();
+	Data = nullptr;
+	DataSize = 0;
+
+	// The region goes before the file it maps
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	LoadedFile.Empty();
+}
+
+bool FThumbnailContainerReader::FindByHash(uint64 PathHash, FThumbnailContainerEntry& OutEntry) const
+{
+	const int32 Found = Algo::LowerBoundBy(Index, PathHash, &FThumbnailContainerIndexEntry::PathHash);
+	if (!Index.IsValidIndex(Found) || Index[Found].PathHash != PathHash)
+	{
+		return false;
+	}
+
+	// Entries are all before the index
+	const FThumbnailContainerIndexEntry& Entry = Index[Found];
+	const uint64 IndexOffset = reinterpret_cast<const uint8*>(Index.GetData()) - Data;
+	if (Entry.Offset + Entry.Size > IndexOffset || !ThumbnailContainer::IsKnownFormat(Entry.Format))
+	{
+		return false;
+	}
+
+	OutEntry.Format = static_cast<EThumbnailContainerEntryFormat>(Entry.Format);
+	OutEntry.Size = FIntPoint(Entry.Width, Entry.Height);
+	OutEntry.Data = TArrayView64<const uint8>(Data + Entry.Offset, Entry.Size);
+	return true;
+}
+
+bool FThumbnailContainerReader::DecodePixels(const FThumbnailContainerEntry& Entry, TArray<FColor>& OutPixels)
+{
+	const int64 NumPixels = static_cast<int64>(Entry.Size.X) * Entry.Size.Y;
+	if (Entry.Format == EThumbnailContainerEntryFormat::BGRA8)
+	{
+		if (Entry.Data.Num() != NumPixels * static_cast<int64>(sizeof(FColor)))
+		{
+			return false;
+		}
+
+		OutPixels.SetNumUninitialized(static_cast<int32>(NumPixels));
+		FMemory::Memcpy(OutPixels.GetData(), Entry.Data.GetData(), Entry.Data.Num());
+		return true;
+	}
+
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+	FImage Image;
+	if (!ImageWrapperModule.DecompressImage(Entry.Data.GetData(), Entry.Data.Num(), Image) || Image.GetNumPixels() != NumPixels)
+	{
+		return false;
+	}
+
+	Image.ChangeFormat(ERawImageFormat::BGRA8, EGammaSpace::sRGB);
+	const TArrayView64<FColor> Pixels = Image.AsBGRA8();
+	OutPixels = TArray<FColor>(Pixels.GetData(), static_cast<int32>(Pixels.Num()));
+	return true;
+}
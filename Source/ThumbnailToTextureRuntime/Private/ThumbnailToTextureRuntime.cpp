@@ -0,0 +1,5 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, ThumbnailToTextureRuntime);
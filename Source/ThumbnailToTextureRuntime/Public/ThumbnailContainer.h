@@ -0,0 +1,123 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ThumbnailContainer.generated.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * How the thumbnails are stored in a container
+ */
+UENUM()
+enum class EThumbnailContainerEntryFormat : uint8
+{
+	/** Uncompressed pixels, read straight from the container without decoding */
+	BGRA8,
+	PNG,
+	JPEG
+};
+
+/**
+ * A thumbnail container is one file holding the exported thumbnails of many assets, in place of a package or an image file per asset:
+ *   the data of the entries, each aligned to ThumbnailContainer::Alignment, appended as the thumbnails are exported,
+ *   then the index, an FThumbnailContainerIndexEntry per asset sorted by path hash,
+ *   then an FThumbnailContainerTrailer, the last bytes of the file.
+ * The file is only ever appended to. Exporting into an existing container appends the new entries then a new index covering
+ * the old and the new ones, replaced entries and the former index stay behind as dead bytes. Everything is little endian.
+ * The format and the reader live in this runtime module so games can ship containers, the writer is in the editor module.
+ */
+namespace ThumbnailContainer
+{
+	constexpr uint32 Magic = 0x4E435454; // "TTCN"
+	constexpr uint32 Version = 1;
+
+	/** Of the entries and the index, so BGRA8 entries and the index can be used in place */
+	constexpr int64 Alignment = 16;
+
+	/** @return key of an asset in the index, the hash of its object path ignoring case */
+	THUMBNAILTOTEXTURERUNTIME_API uint64 HashAssetPath(FStringView AssetPath);
+}
+
+struct FThumbnailContainerIndexEntry
+{
+	uint64 PathHash = 0;
+
+	/** Of the data from the start of the file */
+	uint64 Offset = 0;
+	uint32 Size = 0;
+
+	uint16 Width = 0;
+	uint16 Height = 0;
+
+	/** EThumbnailContainerEntryFormat */
+	uint8 Format = 0;
+	uint8 Padding[7] = {};
+};
+static_assert(sizeof(FThumbnailContainerIndexEntry) == 32, "The index is read in place, its layout is part of the file format");
+
+struct FThumbnailContainerTrailer
+{
+	uint64 IndexOffset = 0;
+	uint32 NumEntries = 0;
+	uint32 Version = ThumbnailContainer::Version;
+	uint32 Magic = ThumbnailContainer::Magic;
+	uint32 Padding = 0;
+};
+static_assert(sizeof(FThumbnailContainerTrailer) == 24, "The trailer is read in place, its layout is part of the file format");
+
+/**
+ * A thumbnail found in a container
+ */
+struct FThumbnailContainerEntry
+{
+	EThumbnailContainerEntryFormat Format = EThumbnailContainerEntryFormat::BGRA8;
+	FIntPoint Size = FIntPoint::ZeroValue;
+
+	/** The stored bytes, Size.X * Size.Y FColor for BGRA8 or the encoded file. Points into the container, valid until the reader is closed */
+	TArrayView64<const uint8> Data;
+};
+
+/**
+ * Finds thumbnails in a container, for the tools and runtimes shipping the container.
+ * The file is memory mapped where the platform can, so opening only reads the trailer and a lookup is a binary search of the index
+ * that hands out a view of the stored bytes, nothing is copied.
+ */
+class THUMBNAILTOTEXTURERUNTIME_API FThumbnailContainerReader
+{
+public:
+	FThumbnailContainerReader();
+	~FThumbnailContainerReader();
+
+	/** False if the file is missing or isn't a valid container */
+	bool Open(const FString& Filename);
+	void Close();
+
+	bool IsOpen() const { return Data != nullptr; }
+	int32 Num() const { return Index.Num(); }
+
+	/** Every entry, sorted by path hash */
+	TArrayView<const FThumbnailContainerIndexEntry> GetIndex() const { return Index; }
+
+	/** False if the asset has no thumbnail in the container */
+	bool Find(FStringView AssetPath, FThumbnailContainerEntry& OutEntry) const { return FindByHash(ThumbnailContainer::HashAssetPath(AssetPath), OutEntry); }
+	bool FindByHash(uint64 PathHash, FThumbnailContainerEntry& OutEntry) const;
+
+	/** Decodes an entry to Size.X * Size.Y pixels, top row first. The image wrappers are loaded by the first call, which must be on the game thread */
+	static bool DecodePixels(const FThumbnailContainerEntry& Entry, TArray<FColor>& OutPixels);
+
+private:
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/** The whole file, when the platform can't map it */
+	TArray64<uint8> LoadedFile;
+
+	const uint8* Data;
+	int64 DataSize;
+
+	/** Points into the file */
+	TArrayView<const FThumbnailContainerIndexEntry> Index;
+};
@@ -0,0 +1,27 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "ThumbnailImpostorUserData.generated.h"
+
+/**
+ * Layout of an octahedral impostor atlas exported by the Thumbnail To Texture tool, added to the texture so it survives cooking.
+ * The atlas holds two GridSize x GridSize grids stacked top to bottom: the color with its alpha, then the world normal with the depth
+ * in its alpha, normalized to the bounding sphere of the asset.
+ */
+UCLASS(BlueprintType)
+class THUMBNAILTOTEXTURERUNTIME_API UThumbnailImpostorUserData : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	/** Views along each side of a grid */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Thumbnail Impostor")
+	int32 GridSize = 0;
+
+	/** The views cover the whole sphere of directions instead of the upper hemisphere */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Thumbnail Impostor")
+	bool bFullSphere = false;
+};
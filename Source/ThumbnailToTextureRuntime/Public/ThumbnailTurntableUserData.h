@@ -0,0 +1,30 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "ThumbnailTurntableUserData.generated.h"
+
+/**
+ * Layout of a turntable sprite sheet exported by the Thumbnail To Texture tool, added to the texture so it survives cooking.
+ * Frame 0 is the regular thumbnail view, the frames are laid out left to right then top to bottom and turn by YawStepDegrees each.
+ */
+UCLASS(BlueprintType)
+class THUMBNAILTOTEXTURERUNTIME_API UThumbnailTurntableUserData : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Thumbnail Turntable")
+	int32 NumFrames = 1;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Thumbnail Turntable")
+	int32 NumColumns = 1;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Thumbnail Turntable")
+	int32 NumRows = 1;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Thumbnail Turntable")
+	float YawStepDegrees = 0.f;
+};
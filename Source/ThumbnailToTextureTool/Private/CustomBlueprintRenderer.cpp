@@ -4,7 +4,11 @@
 
 #include "CustomThumbnailHelpers.h"
 #include "IThumbnailToTextureTool.h"
+#include "ThumbnailImpostorLayout.h"
+#include "ThumbnailSceneCache.h"
 #include "ThumbnailToTextureSettings.h"
+#include "ThumbnailToTextureStats.h"
+#include "ThumbnailTurntableLayout.h"
 #include "Kismet2/KismetEditorUtilities.h"
 #include "ThumbnailRendering/ThumbnailManager.h"
 #if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION <= 2
@@ -34,14 +38,11 @@ void UCustomBlueprintRenderer::Draw(UObject* Object, int32 X, int32 Y, uint32 Wi
 		&& !Blueprint->HasAnyFlags(RF_Transient);
 	if (bIsBlueprintValid)
 	{
-		TSharedRef<FCustomBlueprintThumbnailScene> ThumbnailScene = CustomThumbnailScenes.EnsureThumbnailScene(Blueprint->GeneratedClass);
+		TSharedRef<FCustomBlueprintThumbnailScene> ThumbnailScene = IThumbnailToTextureToolModule::GetPreviewSceneCache().FindOrCreate<FCustomBlueprintThumbnailScene>(this, Blueprint->GeneratedClass);
 
 		ThumbnailScene->SetBlueprint(Blueprint);
-		IThumbnailToTextureToolModule& Module = FModuleManager::GetModuleChecked<IThumbnailToTextureToolModule>("ThumbnailToTextureTool");
-
-		const bool IsTransparent = Module.GetEditorSettings().UseTransparentBackground;
-		UMaterial* MaterialInstance = Cast<UMaterial>( Module.GetEditorSettings().GetBackgroundMaterial());
-		ThumbnailScene->SetMaterial(MaterialInstance, IsTransparent);
+		const UThumbnailToTextureSettings& Settings = IThumbnailToTextureToolModule::GetEditorSettings();
+		ThumbnailScene->SetMaterial(Settings.GetBackgroundMaterial(), Settings.UseTransparentBackground);
 		
 		FSceneViewFamilyContext ViewFamily( FSceneViewFamily::ConstructionValues( RenderTarget, ThumbnailScene->GetScene(), FEngineShowFlags(ESFIM_Game) )
 			.SetTime(UThumbnailRenderer::GetTime())
@@ -55,6 +56,135 @@ void UCustomBlueprintRenderer::Draw(UObject* Object, int32 X, int32 Y, uint32 Wi
 	}
 }
 
+FThumbnailStreamingWaitResult UCustomBlueprintRenderer::DrawBatch(TArrayView<UObject* const> Objects, TArrayView<const FIntRect> Tiles, FRenderTarget* RenderTarget, FCanvas* Canvas, bool bAdditionalViewFamily, const FThumbnailToTextureSettingsSnapshot& Settings)
+{
+	check(Objects.Num() == Tiles.Num());
+
+	TArray<UBlueprint*> Blueprints;
+	TArray<FIntRect> BlueprintTiles;
+	for (int32 Index = 0; Index < Objects.Num(); ++Index)
+	{
+		UBlueprint* Blueprint = Cast<UBlueprint>(Objects[Index]);
+
+		// Same validation as Draw()
+		const bool bIsBlueprintValid = IsValid(Blueprint)
+			&& IsValid(Blueprint->GeneratedClass)
+			&& Blueprint->bHasBeenRegenerated
+			&& !Blueprint->bBeingCompiled
+			&& !Blueprint->HasAnyFlags(RF_Transient);
+		if (bIsBlueprintValid)
+		{
+			Blueprints.Add(Blueprint);
+			BlueprintTiles.Add(Tiles[Index]);
+		}
+	}
+
+	if (Blueprints.Num() == 0)
+	{
+		return {};
+	}
+
+	THUMBNAILTOTEXTURE_COUNT(SceneSetup, 1);
+	{
+		THUMBNAILTOTEXTURE_SCOPE(SceneSetup);
+		PrewarmScene();
+		BatchThumbnailScene->SetBlueprints(Blueprints);
+	}
+
+	BatchThumbnailScene->SetMaterial(Settings.BackgroundMaterial.Get(), Settings.bUseTransparentBackground);
+
+	// Draw once every mip is in rather than capturing whatever happens to be resident
+	const FThumbnailStreamingWaitResult StreamingWait = BatchThumbnailScene->WaitForStreaming(Settings.StreamingWaitTimeoutSeconds);
+
+	const FThumbnailImpostorLayout ImpostorLayout(Settings.ImpostorGridSize, Settings.bImpostorFullSphere);
+	if (ImpostorLayout.IsImpostor())
+	{
+		DrawImpostorBatch(BlueprintTiles, RenderTarget, Canvas, bAdditionalViewFamily, ImpostorLayout);
+	}
+	else
+	{
+		FSceneViewFamilyContext ViewFamily( FSceneViewFamily::ConstructionValues( RenderTarget, BatchThumbnailScene->GetScene(), FEngineShowFlags(ESFIM_Game) )
+			.SetTime(UThumbnailRenderer::GetTime())
+			.SetAdditionalViewFamily(bAdditionalViewFamily));
+
+		ViewFamily.EngineShowFlags.DisableAdvancedFeatures();
+		ViewFamily.EngineShowFlags.MotionBlur = 0;
+		ViewFamily.EngineShowFlags.LOD = 0;
+
+		// One view per blueprint, each only sees its own slot of the scene, a turntable gets one per frame turned further around the orbit
+		const FThumbnailTurntableLayout Layout(Settings.NumTurntableFrames);
+		FSceneView* FirstView = nullptr;
+		for (int32 SlotIndex = 0; SlotIndex < BlueprintTiles.Num(); ++SlotIndex)
+		{
+			for (int32 FrameIndex = 0; FrameIndex < Layout.NumFrames; ++FrameIndex)
+			{
+				const FIntRect Frame = Layout.GetFrameRect(BlueprintTiles[SlotIndex], FrameIndex);
+				FSceneView* View = BatchThumbnailScene->CreateSlotView(&ViewFamily, SlotIndex, Frame.Min.X, Frame.Min.Y, Frame.Width(), Frame.Height(), Layout.GetFrameYaw(FrameIndex));
+				FirstView = FirstView ? FirstView : View;
+			}
+		}
+
+		RenderViewFamily(Canvas, &ViewFamily, FirstView);
+	}
+
+	// Don't keep the batch's actors alive until the next batch, unless the next batch may reuse them
+	if (NumPersistentSceneUsers == 0)
+	{
+		BatchThumbnailScene->SetBlueprints({});
+	}
+
+	return StreamingWait;
+}
+
+void UCustomBlueprintRenderer::DrawImpostorBatch(TArrayView<const FIntRect> Tiles, FRenderTarget* RenderTarget, FCanvas* Canvas, bool bAdditionalViewFamily, const FThumbnailImpostorLayout& Layout)
+{
+	// The buffer visualization is a show flag of the whole family, each layer is a scene render of its own
+	for (int32 LayerIndex = 0; LayerIndex < FThumbnailImpostorLayout::NumRenderedLayers; ++LayerIndex)
+	{
+		const EThumbnailImpostorLayer Layer = static_cast<EThumbnailImpostorLayer>(LayerIndex);
+
+		FSceneViewFamilyContext ViewFamily( FSceneViewFamily::ConstructionValues( RenderTarget, BatchThumbnailScene->GetScene(), FEngineShowFlags(ESFIM_Game) )
+			.SetTime(UThumbnailRenderer::GetTime())
+			.SetAdditionalViewFamily(bAdditionalViewFamily));
+
+		ViewFamily.EngineShowFlags.DisableAdvancedFeatures();
+		ViewFamily.EngineShowFlags.MotionBlur = 0;
+		ViewFamily.EngineShowFlags.LOD = 0;
+		ViewFamily.EngineShowFlags.SetVisualizeBuffer(!FThumbnailImpostorLayout::GetBufferVisualizationMode(Layer).IsNone());
+
+		FSceneView* FirstView = nullptr;
+		for (int32 SlotIndex = 0; SlotIndex < Tiles.Num(); ++SlotIndex)
+		{
+			FSceneView* View = BatchThumbnailScene->CreateSlotImpostorViews(&ViewFamily, SlotIndex, Tiles[SlotIndex], Layout, Layer);
+			FirstView = FirstView ? FirstView : View;
+		}
+
+		RenderViewFamily(Canvas, &ViewFamily, FirstView);
+	}
+}
+
+void UCustomBlueprintRenderer::BeginPersistentScene()
+{
+	++NumPersistentSceneUsers;
+}
+
+void UCustomBlueprintRenderer::EndPersistentScene()
+{
+	check(NumPersistentSceneUsers > 0);
+	if (--NumPersistentSceneUsers == 0 && BatchThumbnailScene.IsValid())
+	{
+		BatchThumbnailScene->SetBlueprints({});
+	}
+}
+
+void UCustomBlueprintRenderer::PrewarmScene()
+{
+	if (!BatchThumbnailScene.IsValid() || !ensure(BatchThumbnailScene->GetWorld() != nullptr))
+	{
+		BatchThumbnailScene = MakeShared<FCustomBlueprintThumbnailScene>();
+	}
+}
+
 bool UCustomBlueprintRenderer::CanVisualizeAsset(UObject* Object)
 {
 	UBlueprint* Blueprint = Cast<UBlueprint>(Object);
@@ -136,7 +266,8 @@ bool UCustomBlueprintRenderer::CanVisualizeAsset(UObject* Object)
 void UCustomBlueprintRenderer::BeginDestroy()
 {
 	FKismetEditorUtilities::OnBlueprintUnloaded.RemoveAll(this);
-	CustomThumbnailScenes.Clear();
+	// The scenes of Draw() are freed along with the module's FThumbnailSceneCache, the renderer only goes away once the module shut down
+	BatchThumbnailScene.Reset();
 
 	Super::BeginDestroy();
 }
@@ -145,7 +276,7 @@ void UCustomBlueprintRenderer::BlueprintChanged(UBlueprint* Blueprint)
 {
 	if (Blueprint && Blueprint->GeneratedClass)
 	{
-		TSharedPtr<FCustomBlueprintThumbnailScene> ThumbnailScene = CustomThumbnailScenes.FindThumbnailScene(Blueprint->GeneratedClass);
+		TSharedPtr<FCustomBlueprintThumbnailScene> ThumbnailScene = IThumbnailToTextureToolModule::GetPreviewSceneCache().Find<FCustomBlueprintThumbnailScene>(this, Blueprint->GeneratedClass);
 		if (ThumbnailScene.IsValid())
 		{
 			ThumbnailScene->BlueprintChanged(Blueprint);
@@ -157,6 +288,6 @@ void UCustomBlueprintRenderer::OnBlueprintUnloaded(UBlueprint* Blueprint)
 {
 	if (Blueprint && Blueprint->GeneratedClass)
 	{
-		CustomThumbnailScenes.RemoveThumbnailScene(Blueprint->GeneratedClass);
+		IThumbnailToTextureToolModule::GetPreviewSceneCache().Remove(this, Blueprint->GeneratedClass);
 	}
 }
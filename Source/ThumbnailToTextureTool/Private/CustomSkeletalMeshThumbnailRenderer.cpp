@@ -11,6 +11,7 @@
 #include "SceneView.h"
 #include "Engine/SkeletalMesh.h"
 #include "ThumbnailHelpers.h"
+#include "ThumbnailSceneCache.h"
 #include "ThumbnailToTextureSettings.h"
 
 UCustomSkeletalMeshThumbnailRenderer::UCustomSkeletalMeshThumbnailRenderer(const FObjectInitializer& ObjectInitializer)
@@ -21,7 +22,7 @@ UCustomSkeletalMeshThumbnailRenderer::UCustomSkeletalMeshThumbnailRenderer(const
 void UCustomSkeletalMeshThumbnailRenderer::Draw(UObject* Object, int32 X, int32 Y, uint32 Width, uint32 Height, FRenderTarget* RenderTarget, FCanvas* Canvas, bool bAdditionalViewFamily)
 {
 	USkeletalMesh* SkeletalMesh = Cast<USkeletalMesh>(Object);
-	TSharedRef<FCustomSkeletalMeshThumbnailScene> ThumbnailScene = ThumbnailSceneCache.EnsureThumbnailScene(Object);
+	TSharedRef<FCustomSkeletalMeshThumbnailScene> ThumbnailScene = IThumbnailToTextureToolModule::GetPreviewSceneCache().FindOrCreate<FCustomSkeletalMeshThumbnailScene>(this, Object);
 
 	if(SkeletalMesh)
 	{
@@ -37,11 +38,8 @@ void UCustomSkeletalMeshThumbnailRenderer::Draw(UObject* Object, int32 X, int32
 	ViewFamily.EngineShowFlags.MotionBlur = 0;
 	ViewFamily.EngineShowFlags.LOD = 0;
 
-	IThumbnailToTextureToolModule& Module = FModuleManager::GetModuleChecked<IThumbnailToTextureToolModule>("ThumbnailToTextureTool");
-
-	const bool IsTransparent = Module.GetEditorSettings().UseTransparentBackground;
-	UMaterial* MaterialInstance = Cast<UMaterial>( Module.GetEditorSettings().GetBackgroundMaterial());
-	ThumbnailScene->SetMaterial(MaterialInstance, IsTransparent);
+	const UThumbnailToTextureSettings& Settings = IThumbnailToTextureToolModule::GetEditorSettings();
+	ThumbnailScene->SetMaterial(Settings.GetBackgroundMaterial(), Settings.UseTransparentBackground);
 	
 	RenderViewFamily(Canvas, &ViewFamily, ThumbnailScene->CreateView(&ViewFamily, X, Y, Width, Height));
 	ThumbnailScene->SetSkeletalMesh(nullptr);
@@ -68,7 +66,6 @@ bool UCustomSkeletalMeshThumbnailRenderer::CanVisualizeAsset(UObject* Object)
 
 void UCustomSkeletalMeshThumbnailRenderer::BeginDestroy()
 {
-	ThumbnailSceneCache.Clear();
-
+	// The scenes of Draw() are freed along with the module's FThumbnailSceneCache, the renderer only goes away once the module shut down
 	Super::BeginDestroy();
 }
@@ -8,13 +8,17 @@
 #include "ShowFlags.h"
 #include "SceneInterface.h"
 #include "SceneView.h"
+#include "ThumbnailImpostorLayout.h"
 #include "ThumbnailToTextureSettings.h"
+#include "ThumbnailToTextureStats.h"
+#include "ThumbnailTurntableLayout.h"
 #include "Engine/StaticMesh.h"
 
 UCustomStaticMeshThumbnailRenderer::UCustomStaticMeshThumbnailRenderer(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
 	ThumbnailScene = nullptr;
+	NumPersistentSceneUsers = 0;
 }
 
 void UCustomStaticMeshThumbnailRenderer::Draw(UObject* Object, int32 X, int32 Y, uint32 Width, uint32 Height, FRenderTarget* RenderTarget, FCanvas* Canvas, bool bAdditionalViewFamily)
@@ -22,18 +26,110 @@ void UCustomStaticMeshThumbnailRenderer::Draw(UObject* Object, int32 X, int32 Y,
 	UStaticMesh* StaticMesh = Cast<UStaticMesh>(Object);
 	if (IsValid(StaticMesh))
 	{
-		if (ThumbnailScene == nullptr || ensure(ThumbnailScene->GetWorld() != nullptr) == false)
+		PrewarmScene();
+
+		ThumbnailScene->SetStaticMesh(StaticMesh);
+		ThumbnailScene->GetScene()->UpdateSpeedTreeWind(0.0);
+
+		FSceneViewFamilyContext ViewFamily( FSceneViewFamily::ConstructionValues( RenderTarget, ThumbnailScene->GetScene(), FEngineShowFlags(ESFIM_Game) )
+			.SetTime(UThumbnailRenderer::GetTime())
+			.SetAdditionalViewFamily(bAdditionalViewFamily));
+
+		ViewFamily.EngineShowFlags.DisableAdvancedFeatures();
+		ViewFamily.EngineShowFlags.MotionBlur = 0;
+		ViewFamily.EngineShowFlags.LOD = 0;
+
+		const UThumbnailToTextureSettings& Settings = IThumbnailToTextureToolModule::GetEditorSettings();
+		ThumbnailScene->SetMaterial(Settings.GetBackgroundMaterial(), Settings.UseTransparentBackground);
+		
+		RenderViewFamily(Canvas, &ViewFamily, ThumbnailScene->CreateView(&ViewFamily, X, Y, Width, Height));
+		if (NumPersistentSceneUsers == 0)
 		{
-			if (ThumbnailScene)
+			ThumbnailScene->SetStaticMesh(nullptr);
+		}
+	}
+}
+
+FThumbnailStreamingWaitResult UCustomStaticMeshThumbnailRenderer::DrawBatch(TArrayView<UObject* const> Objects, TArrayView<const FIntRect> Tiles, FRenderTarget* RenderTarget, FCanvas* Canvas, bool bAdditionalViewFamily, const FThumbnailToTextureSettingsSnapshot& Settings)
+{
+	check(Objects.Num() == Tiles.Num());
+
+	TArray<UStaticMesh*> StaticMeshes;
+	TArray<FIntRect> StaticMeshTiles;
+	for (int32 Index = 0; Index < Objects.Num(); ++Index)
+	{
+		UStaticMesh* StaticMesh = Cast<UStaticMesh>(Objects[Index]);
+		if (IsValid(StaticMesh))
+		{
+			StaticMeshes.Add(StaticMesh);
+			StaticMeshTiles.Add(Tiles[Index]);
+		}
+	}
+
+	if (StaticMeshes.Num() == 0)
+	{
+		return {};
+	}
+
+	THUMBNAILTOTEXTURE_COUNT(SceneSetup, 1);
+	{
+		THUMBNAILTOTEXTURE_SCOPE(SceneSetup);
+		PrewarmScene();
+
+		ThumbnailScene->SetStaticMeshes(StaticMeshes);
+		ThumbnailScene->GetScene()->UpdateSpeedTreeWind(0.0);
+	}
+
+	// Draw once every mip is in rather than capturing whatever happens to be resident
+	const FThumbnailStreamingWaitResult StreamingWait = ThumbnailScene->WaitForStreaming(Settings.StreamingWaitTimeoutSeconds);
+
+	ThumbnailScene->SetMaterial(Settings.BackgroundMaterial.Get(), Settings.bUseTransparentBackground);
+
+	const FThumbnailImpostorLayout ImpostorLayout(Settings.ImpostorGridSize, Settings.bImpostorFullSphere);
+	if (ImpostorLayout.IsImpostor())
+	{
+		DrawImpostorBatch(StaticMeshTiles, RenderTarget, Canvas, bAdditionalViewFamily, ImpostorLayout);
+	}
+	else
+	{
+		FSceneViewFamilyContext ViewFamily( FSceneViewFamily::ConstructionValues( RenderTarget, ThumbnailScene->GetScene(), FEngineShowFlags(ESFIM_Game) )
+			.SetTime(UThumbnailRenderer::GetTime())
+			.SetAdditionalViewFamily(bAdditionalViewFamily));
+
+		ViewFamily.EngineShowFlags.DisableAdvancedFeatures();
+		ViewFamily.EngineShowFlags.MotionBlur = 0;
+		ViewFamily.EngineShowFlags.LOD = 0;
+
+		// One view per mesh, each only sees its own slot of the scene, a turntable gets one per frame turned further around the orbit
+		const FThumbnailTurntableLayout Layout(Settings.NumTurntableFrames);
+		FSceneView* FirstView = nullptr;
+		for (int32 SlotIndex = 0; SlotIndex < StaticMeshTiles.Num(); ++SlotIndex)
+		{
+			for (int32 FrameIndex = 0; FrameIndex < Layout.NumFrames; ++FrameIndex)
 			{
-				FlushRenderingCommands();
-				delete ThumbnailScene;
+				const FIntRect Frame = Layout.GetFrameRect(StaticMeshTiles[SlotIndex], FrameIndex);
+				FSceneView* View = ThumbnailScene->CreateSlotView(&ViewFamily, SlotIndex, Frame.Min.X, Frame.Min.Y, Frame.Width(), Frame.Height(), Layout.GetFrameYaw(FrameIndex));
+				FirstView = FirstView ? FirstView : View;
 			}
-			ThumbnailScene = new FCustomStaticMeshThumbnailScene();
 		}
 
-		ThumbnailScene->SetStaticMesh(StaticMesh);
-		ThumbnailScene->GetScene()->UpdateSpeedTreeWind(0.0);
+		RenderViewFamily(Canvas, &ViewFamily, FirstView);
+	}
+
+	if (NumPersistentSceneUsers == 0)
+	{
+		ThumbnailScene->SetStaticMeshes({});
+	}
+
+	return StreamingWait;
+}
+
+void UCustomStaticMeshThumbnailRenderer::DrawImpostorBatch(TArrayView<const FIntRect> Tiles, FRenderTarget* RenderTarget, FCanvas* Canvas, bool bAdditionalViewFamily, const FThumbnailImpostorLayout& Layout)
+{
+	// The buffer visualization is a show flag of the whole family, each layer is a scene render of its own
+	for (int32 LayerIndex = 0; LayerIndex < FThumbnailImpostorLayout::NumRenderedLayers; ++LayerIndex)
+	{
+		const EThumbnailImpostorLayer Layer = static_cast<EThumbnailImpostorLayer>(LayerIndex);
 
 		FSceneViewFamilyContext ViewFamily( FSceneViewFamily::ConstructionValues( RenderTarget, ThumbnailScene->GetScene(), FEngineShowFlags(ESFIM_Game) )
 			.SetTime(UThumbnailRenderer::GetTime())
@@ -42,15 +138,43 @@ void UCustomStaticMeshThumbnailRenderer::Draw(UObject* Object, int32 X, int32 Y,
 		ViewFamily.EngineShowFlags.DisableAdvancedFeatures();
 		ViewFamily.EngineShowFlags.MotionBlur = 0;
 		ViewFamily.EngineShowFlags.LOD = 0;
+		ViewFamily.EngineShowFlags.SetVisualizeBuffer(!FThumbnailImpostorLayout::GetBufferVisualizationMode(Layer).IsNone());
 
-		IThumbnailToTextureToolModule& Module = FModuleManager::GetModuleChecked<IThumbnailToTextureToolModule>("ThumbnailToTextureTool");
+		FSceneView* FirstView = nullptr;
+		for (int32 SlotIndex = 0; SlotIndex < Tiles.Num(); ++SlotIndex)
+		{
+			FSceneView* View = ThumbnailScene->CreateSlotImpostorViews(&ViewFamily, SlotIndex, Tiles[SlotIndex], Layout, Layer);
+			FirstView = FirstView ? FirstView : View;
+		}
 
-		const bool IsTransparent = Module.GetEditorSettings().UseTransparentBackground;
-		UMaterial* MaterialInstance = Cast<UMaterial>( Module.GetEditorSettings().GetBackgroundMaterial());
-		ThumbnailScene->SetMaterial(MaterialInstance, IsTransparent);
-		
-		RenderViewFamily(Canvas, &ViewFamily, ThumbnailScene->CreateView(&ViewFamily, X, Y, Width, Height));
-		ThumbnailScene->SetStaticMesh(nullptr);
+		RenderViewFamily(Canvas, &ViewFamily, FirstView);
+	}
+}
+
+void UCustomStaticMeshThumbnailRenderer::BeginPersistentScene()
+{
+	++NumPersistentSceneUsers;
+}
+
+void UCustomStaticMeshThumbnailRenderer::EndPersistentScene()
+{
+	check(NumPersistentSceneUsers > 0);
+	if (--NumPersistentSceneUsers == 0 && ThumbnailScene != nullptr)
+	{
+		ThumbnailScene->SetStaticMeshes({});
+	}
+}
+
+void UCustomStaticMeshThumbnailRenderer::PrewarmScene()
+{
+	if (ThumbnailScene == nullptr || ensure(ThumbnailScene->GetWorld() != nullptr) == false)
+	{
+		if (ThumbnailScene)
+		{
+			FlushRenderingCommands();
+			delete ThumbnailScene;
+		}
+		ThumbnailScene = new FCustomStaticMeshThumbnailScene();
 	}
 }
 
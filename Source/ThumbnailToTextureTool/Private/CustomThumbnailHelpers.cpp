@@ -9,6 +9,14 @@
 #include "Components/DirectionalLightComponent.h"
 #include "Editor/UnrealEdEngine.h"
 #include "Engine/StaticMeshActor.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialExpressionComponentMask.h"
+#include "Materials/MaterialExpressionDivide.h"
+#include "Materials/MaterialExpressionSaturate.h"
+#include "Materials/MaterialExpressionScalarParameter.h"
+#include "Materials/MaterialExpressionSceneTexture.h"
+#include "Materials/MaterialExpressionSubtract.h"
+#include "Materials/MaterialInstanceDynamic.h"
 #include "ThumbnailRendering/SceneThumbnailInfo.h"
 #include "ThumbnailRendering/ThumbnailManager.h"
 
@@ -63,8 +71,14 @@ void FCustomThumbnailPreviewScene::GetView(FSceneViewFamily* ViewFamily, int32 X
 PRAGMA_ENABLE_DEPRECATION_WARNINGS
 
 FSceneView* FCustomThumbnailPreviewScene::CreateView(FSceneViewFamily * ViewFamily, int32 X, int32 Y, uint32 SizeX, uint32 SizeY) const
+{
+	return CreateSlotView(ViewFamily, 0, X, Y, SizeX, SizeY);
+}
+
+FSceneView* FCustomThumbnailPreviewScene::CreateSlotView(FSceneViewFamily* ViewFamily, int32 SlotIndex, int32 X, int32 Y, uint32 SizeX, uint32 SizeY, float YawOffsetDegrees) const
 {
 	check(ViewFamily);
+	check(SlotIndex >= 0 && SlotIndex < GetNumSlots());
 
 	FIntRect ViewRect(
 		FMath::Max<int32>(X,0),
@@ -92,7 +106,8 @@ FSceneView* FCustomThumbnailPreviewScene::CreateView(FSceneViewFamily * ViewFami
 	float OrbitPitch = 0;
 	float OrbitYaw = 0;
 	float OrbitZoom = 0;
-	GetViewMatrixParameters(FOVDegrees, Origin, OrbitPitch, OrbitYaw, OrbitZoom);
+	GetSlotViewMatrixParameters(SlotIndex, FOVDegrees, Origin, OrbitPitch, OrbitYaw, OrbitZoom);
+	OrbitYaw += YawOffsetDegrees;
 
 	// Ensure a minimum camera distance to prevent problems with really small objects
 	const float MinCameraDistance = 48;
@@ -123,6 +138,14 @@ FSceneView* FCustomThumbnailPreviewScene::CreateView(FSceneViewFamily * ViewFami
 
 	FSceneView* NewView = new FSceneView(ViewInitOptions);
 
+	// The other objects of a batch are out of frame, but could still be seen through the background
+	TArray<const UPrimitiveComponent*> OtherSlotComponents;
+	GetOtherSlotPrimitiveComponents(SlotIndex, OtherSlotComponents);
+	for (const UPrimitiveComponent* Component : OtherSlotComponents)
+	{
+		NewView->HiddenPrimitives.Add(Component->ComponentId);
+	}
+
 	ViewFamily->Views.Add(NewView);
 
 	NewView->StartFinalPostprocessSettings( ViewInitOptions.ViewOrigin );
@@ -139,6 +162,192 @@ FSceneView* FCustomThumbnailPreviewScene::CreateView(FSceneViewFamily * ViewFami
 	return NewView;
 }
 
+FSceneView* FCustomThumbnailPreviewScene::CreateSlotImpostorViews(FSceneViewFamily* ViewFamily, int32 SlotIndex, const FIntRect& Tile, const FThumbnailImpostorLayout& Layout, EThumbnailImpostorLayer Layer) const
+{
+	check(ViewFamily);
+	check(SlotIndex >= 0 && SlotIndex < GetNumSlots());
+	check(Layout.IsImpostor());
+
+	if (Tile.Area() <= 0)
+	{
+		return nullptr;
+	}
+
+	const FBoxSphereBounds Bounds = GetSlotBounds(SlotIndex);
+	const double Radius = FMath::Max(Bounds.SphereRadius, 1.0);
+
+	// The floor would hide the views from below, the normal and depth layers only keep the asset
+	TArray<const UPrimitiveComponent*> HiddenComponents;
+	GetOtherSlotPrimitiveComponents(SlotIndex, HiddenComponents);
+	HiddenComponents.Add(BackgroundPlaneComponent);
+	if (Layer != EThumbnailImpostorLayer::Color)
+	{
+		HiddenComponents.Add(BackgroundSkySphereComponent);
+	}
+
+	// From the camera to past the sky sphere, the inside of the sphere behind the camera must not cover the asset
+	static_assert((int32)ERHIZBuffer::IsInverted != 0, "Check the projection matrix");
+	const FMatrix ProjectionMatrix = FReversedZOrthoMatrix(static_cast<float>(Radius), static_cast<float>(Radius), 0.5f / UE_OLD_HALF_WORLD_MAX, 0.f);
+	const FName BufferVisualizationMode = FThumbnailImpostorLayout::GetBufferVisualizationMode(Layer);
+
+	// The cameras are two radii away from the center, the bounding sphere spans the depths from one to three radii
+	UMaterialInstanceDynamic* DepthMaterial = Layer == EThumbnailImpostorLayer::SceneDepth ? GetImpostorDepthMaterial(SlotIndex, Radius, 2.0 * Radius) : nullptr;
+
+	FSceneView* FirstView = nullptr;
+	for (int32 CellY = 0; CellY < Layout.GridSize; ++CellY)
+	{
+		for (int32 CellX = 0; CellX < Layout.GridSize; ++CellX)
+		{
+			const FIntRect ViewRect = Layout.GetViewRect(Tile, Layer, CellX, CellY);
+			const FVector Direction = Layout.GetViewDirection(CellX, CellY);
+
+			// The up of the views is world Z, or world X when looking straight down or up
+			const FVector UpAxis = FMath::Abs(Direction.Z) > 0.999 ? FVector::ForwardVector : FVector::UpVector;
+			const FMatrix CameraRotation = FRotationMatrix::MakeFromXZ(-Direction, UpAxis);
+
+			FSceneViewInitOptions ViewInitOptions;
+			ViewInitOptions.ViewFamily = ViewFamily;
+			ViewInitOptions.SetViewRectangle(ViewRect);
+			ViewInitOptions.ViewOrigin = Bounds.Origin + Direction * (2.0 * Radius);
+			ViewInitOptions.ViewRotationMatrix = CameraRotation.GetTransposed() * FMatrix(
+				FPlane(0,	0,	1,	0),
+				FPlane(1,	0,	0,	0),
+				FPlane(0,	1,	0,	0),
+				FPlane(0,	0,	0,	1));
+			ViewInitOptions.ProjectionMatrix = ProjectionMatrix;
+			ViewInitOptions.BackgroundColor = FLinearColor::Black;
+
+			FSceneView* NewView = new FSceneView(ViewInitOptions);
+			NewView->CurrentBufferVisualizationMode = BufferVisualizationMode;
+			for (const UPrimitiveComponent* Component : HiddenComponents)
+			{
+				NewView->HiddenPrimitives.Add(Component->ComponentId);
+			}
+
+			ViewFamily->Views.Add(NewView);
+
+			NewView->StartFinalPostprocessSettings(ViewInitOptions.ViewOrigin);
+			if (DepthMaterial)
+			{
+				DepthMaterial->OverrideBlendableSettings(*NewView, 1.f);
+			}
+			NewView->EndFinalPostprocessSettings(ViewInitOptions);
+
+			// An orthographic view has no field of view, the asset covers the whole view
+			const float ScreenSize = static_cast<float>(ViewRect.Width());
+			IStreamingManager::Get().AddViewInformation(ViewInitOptions.ViewOrigin, ScreenSize, ScreenSize);
+
+			FirstView = FirstView ? FirstView : NewView;
+		}
+	}
+
+	return FirstView;
+}
+
+void FCustomThumbnailPreviewScene::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	FPreviewScene::AddReferencedObjects(Collector);
+
+	Collector.AddReferencedObject(ImpostorDepthMaterial);
+	Collector.AddReferencedObjects(SlotImpostorDepthMaterials);
+}
+
+UMaterialInstanceDynamic* FCustomThumbnailPreviewScene::GetImpostorDepthMaterial(int32 SlotIndex, double DepthMin, double DepthRange) const
+{
+	static const FName DepthMinName(TEXT("DepthMin"));
+	static const FName DepthRangeName(TEXT("DepthRange"));
+
+	if (!ImpostorDepthMaterial)
+	{
+		// Saturate((SceneDepth - DepthMin) / DepthRange), built here as the plugin ships no content
+		UMaterial* Material = NewObject<UMaterial>(GetTransientPackage(), NAME_None, RF_Transient);
+		Material->MaterialDomain = MD_PostProcess;
+		Material->BlendableLocation = BL_ReplacingTonemapper;
+
+		UMaterialExpressionSceneTexture* SceneDepth = NewObject<UMaterialExpressionSceneTexture>(Material);
+		SceneDepth->SceneTextureId = PPI_SceneDepth;
+
+		UMaterialExpressionComponentMask* SceneDepthR = NewObject<UMaterialExpressionComponentMask>(Material);
+		SceneDepthR->R = true;
+		SceneDepthR->Input.Connect(0, SceneDepth);
+
+		UMaterialExpressionScalarParameter* DepthMinParameter = NewObject<UMaterialExpressionScalarParameter>(Material);
+		DepthMinParameter->ParameterName = DepthMinName;
+
+		UMaterialExpressionScalarParameter* DepthRangeParameter = NewObject<UMaterialExpressionScalarParameter>(Material);
+		DepthRangeParameter->ParameterName = DepthRangeName;
+		DepthRangeParameter->DefaultValue = 1.f;
+
+		UMaterialExpressionSubtract* Subtract = NewObject<UMaterialExpressionSubtract>(Material);
+		Subtract->A.Connect(0, SceneDepthR);
+		Subtract->B.Connect(0, DepthMinParameter);
+
+		UMaterialExpressionDivide* Divide = NewObject<UMaterialExpressionDivide>(Material);
+		Divide->A.Connect(0, Subtract);
+		Divide->B.Connect(0, DepthRangeParameter);
+
+		UMaterialExpressionSaturate* Saturate = NewObject<UMaterialExpressionSaturate>(Material);
+		Saturate->Input.Connect(0, Divide);
+
+		for (UMaterialExpression* Expression : TArray<UMaterialExpression*>{ SceneDepth, SceneDepthR, DepthMinParameter, DepthRangeParameter, Subtract, Divide, Saturate })
+		{
+			Material->GetExpressionCollection().AddExpression(Expression);
+		}
+		Material->GetEditorOnlyData()->EmissiveColor.Connect(0, Saturate);
+
+		// A depth layer drawn with the default material while the shaders compile would be garbage
+		Material->PostEditChange();
+		Material->GetMaterialResource(GMaxRHIFeatureLevel)->FinishCompilation();
+
+		ImpostorDepthMaterial = Material;
+	}
+
+	if (SlotImpostorDepthMaterials.Num() <= SlotIndex)
+	{
+		SlotImpostorDepthMaterials.SetNum(SlotIndex + 1);
+	}
+
+	TObjectPtr<UMaterialInstanceDynamic>& SlotMaterial = SlotImpostorDepthMaterials[SlotIndex];
+	if (!SlotMaterial)
+	{
+		SlotMaterial = UMaterialInstanceDynamic::Create(ImpostorDepthMaterial, GetTransientPackage());
+	}
+
+	SlotMaterial->SetScalarParameterValue(DepthMinName, static_cast<float>(DepthMin));
+	SlotMaterial->SetScalarParameterValue(DepthRangeName, static_cast<float>(DepthRange));
+	return SlotMaterial;
+}
+
+void FCustomThumbnailPreviewScene::GetOtherSlotPrimitiveComponents(int32 SlotIndex, TArray<const UPrimitiveComponent*>& OutComponents) const
+{
+	const int32 NumSlots = GetNumSlots();
+	for (int32 OtherSlotIndex = 0; OtherSlotIndex < NumSlots; ++OtherSlotIndex)
+	{
+		if (OtherSlotIndex != SlotIndex)
+		{
+			GetSlotPrimitiveComponents(OtherSlotIndex, OutComponents);
+		}
+	}
+}
+
+FBoxSphereBounds FCustomThumbnailPreviewScene::GetSlotBounds(int32 SlotIndex) const
+{
+	TArray<const UPrimitiveComponent*> Components;
+	GetSlotPrimitiveComponents(SlotIndex, Components);
+
+	bool bHasBounds = false;
+	FBoxSphereBounds Bounds(ForceInit);
+	for (const UPrimitiveComponent* Component : Components)
+	{
+		if (Component && Component->IsRegistered())
+		{
+			Bounds = bHasBounds ? Bounds + Component->Bounds : Component->Bounds;
+			bHasBounds = true;
+		}
+	}
+	return Bounds;
+}
+
 void FCustomThumbnailPreviewScene::Tick(float DeltaTime)
 {
 	UpdateCaptureContents();
@@ -151,6 +360,14 @@ TStatId FCustomThumbnailPreviewScene::GetStatId() const
 
 void FCustomThumbnailPreviewScene::SetMaterial(UMaterial* Material, bool IsTransparent)
 {
+	if (bMaterialApplied && AppliedMaterial.Get() == Material && bAppliedTransparent == IsTransparent)
+	{
+		return;
+	}
+	bMaterialApplied = true;
+	AppliedMaterial = Material;
+	bAppliedTransparent = IsTransparent;
+
 	if (Material)
 	{
 		BackgroundSkySphereComponent->SetMaterial(0, Material);
@@ -173,12 +390,53 @@ void FCustomThumbnailPreviewScene::SetMaterial(UMaterial* Material, bool IsTrans
 	}
 }
 
+FThumbnailStreamingWaitResult FCustomThumbnailPreviewScene::WaitForStreaming(double TimeoutSeconds) const
+{
+	TArray<const UPrimitiveComponent*> Components;
+	for (int32 SlotIndex = 0; SlotIndex < GetNumSlots(); ++SlotIndex)
+	{
+		GetSlotPrimitiveComponents(SlotIndex, Components);
+	}
+
+	FThumbnailStreamingFence StreamingFence;
+	StreamingFence.AddComponents(Components);
+	return StreamingFence.Wait(TimeoutSeconds);
+}
+
 float FCustomThumbnailPreviewScene::GetBoundsZOffset(const FBoxSphereBounds& Bounds) const
 {
 	// Return half the height of the bounds plus one to avoid ZFighting with the floor plane
 	return static_cast<float>(Bounds.BoxExtent.Z + 1.0);
 }
 
+void FCustomThumbnailPreviewScene::GetSlotViewMatrixParameters(int32 SlotIndex, const float InFOVDegrees, FVector& OutOrigin, float& OutOrbitPitch, float& OutOrbitYaw, float& OutOrbitZoom) const
+{
+	check(SlotIndex == 0);
+	GetViewMatrixParameters(InFOVDegrees, OutOrigin, OutOrbitPitch, OutOrbitYaw, OutOrbitZoom);
+}
+
+float FCustomThumbnailPreviewScene::GetSlotSpacing(float MaxSphereRadius)
+{
+	// Leave room for the longest shadow of the directional lights on the floor plane
+	const float MinSlotSpacing = 500.f;
+	return MinSlotSpacing + MaxSphereRadius * 8.f;
+}
+
+FVector FCustomThumbnailPreviewScene::GetSlotOffset(int32 SlotIndex, int32 NumSlots, float SlotSpacing)
+{
+	if (NumSlots <= 1)
+	{
+		return FVector::ZeroVector;
+	}
+
+	// Keep the grid square so every slot stays well inside the sky sphere
+	const int32 NumColumns = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumSlots)));
+	const int32 NumRows = FMath::DivideAndRoundUp(NumSlots, NumColumns);
+	const float Column = static_cast<float>(SlotIndex % NumColumns) - (NumColumns - 1) * 0.5f;
+	const float Row = static_cast<float>(SlotIndex / NumColumns) - (NumRows - 1) * 0.5f;
+	return FVector(Column * SlotSpacing, Row * SlotSpacing, 0);
+}
+
 /*
 ***************************************************************
   FCustomClassActorThumbnailScene
@@ -189,48 +447,90 @@ FCustomClassActorThumbnailScene::FCustomClassActorThumbnailScene()
 	: FCustomThumbnailPreviewScene()
 	, NumStartingActors(0)
 	, PreviewActor(nullptr)
+	, NumSlots(1)
+	, SlotSpacing(0.f)
 {
 	NumStartingActors = GetWorld()->GetCurrentLevel()->Actors.Num();
 }
 
 void FCustomClassActorThumbnailScene::SpawnPreviewActor(UClass* InClass)
 {
-	if (PreviewActor.IsStale())
+	SpawnPreviewActors(MakeArrayView(&InClass, 1));
+}
+
+void FCustomClassActorThumbnailScene::SpawnPreviewActors(TArrayView<UClass* const> Classes)
+{
+	const bool bHasStaleActor = PreviewActor.IsStale() || BatchPreviewActors.ContainsByPredicate([](const TWeakObjectPtr<AActor>& Actor)
+	{
+		return Actor.IsStale();
+	});
+	if (bHasStaleActor)
 	{
 		PreviewActor = nullptr;
+		BatchPreviewActors.Reset();
 		ClearStaleActors();
 	}
 
-	if (PreviewActor.IsValid())
+	// Destroy the actors of the slots the previous batch had in excess
+	const int32 NewNumSlots = FMath::Max(1, Classes.Num());
+	for (int32 BatchIndex = NewNumSlots - 1; BatchIndex < BatchPreviewActors.Num(); ++BatchIndex)
 	{
-		if (PreviewActor->GetClass() == InClass)
+		if (BatchPreviewActors[BatchIndex].IsValid())
 		{
-			return;
+			BatchPreviewActors[BatchIndex]->Destroy();
 		}
-
-		PreviewActor->Destroy();
-		PreviewActor = nullptr;
 	}
-	if (InClass && !InClass->HasAnyClassFlags(CLASS_Deprecated | CLASS_Abstract))
+	BatchPreviewActors.SetNum(NewNumSlots - 1);
+	NumSlots = NewNumSlots;
+
+	float MaxSphereRadius = 0.f;
+	for (int32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
 	{
-		// Create preview actor
-		FActorSpawnParameters SpawnInfo;
-		SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-		SpawnInfo.bNoFail = true;
-		SpawnInfo.ObjectFlags = RF_Transient;
-		PreviewActor = GetWorld()->SpawnActor<AActor>(InClass, SpawnInfo);
+		TWeakObjectPtr<AActor>& SlotActor = SlotIndex == 0 ? PreviewActor : BatchPreviewActors[SlotIndex - 1];
+		UClass* InClass = Classes.IsValidIndex(SlotIndex) ? Classes[SlotIndex] : nullptr;
 
-		if (PreviewActor.IsValid())
+		if (SlotActor.IsValid() && SlotActor->GetClass() != InClass)
 		{
-			const FBoxSphereBounds Bounds = GetPreviewActorBounds();
+			SlotActor->Destroy();
+			SlotActor = nullptr;
+		}
+
+		if (!SlotActor.IsValid() && InClass && !InClass->HasAnyClassFlags(CLASS_Deprecated | CLASS_Abstract))
+		{
+			// Create preview actor
+			FActorSpawnParameters SpawnInfo;
+			SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			SpawnInfo.bNoFail = true;
+			SpawnInfo.ObjectFlags = RF_Transient;
+			SlotActor = GetWorld()->SpawnActor<AActor>(InClass, SpawnInfo);
+		}
+
+		if (SlotActor.IsValid())
+		{
+			MaxSphereRadius = FMath::Max(MaxSphereRadius, static_cast<float>(GetActorBounds(SlotActor.Get()).SphereRadius));
+		}
+	}
+
+	SlotSpacing = GetSlotSpacing(MaxSphereRadius);
+	for (int32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+	{
+		if (AActor* SlotActor = GetSlotActor(SlotIndex))
+		{
+			// Bounds only depend on the translation through their origin, which is compensated
+			const FBoxSphereBounds Bounds = GetActorBounds(SlotActor);
 			const float BoundsZOffset = GetBoundsZOffset(Bounds);
-			const FTransform Transform(-Bounds.Origin + FVector(0, 0, BoundsZOffset));
+			const FTransform Transform(SlotActor->GetActorLocation() - Bounds.Origin + FVector(0, 0, BoundsZOffset) + GetSlotOffset(SlotIndex, NumSlots, SlotSpacing));
 
-			PreviewActor->SetActorTransform(Transform);
+			SlotActor->SetActorTransform(Transform);
 		}
 	}
 }
 
+AActor* FCustomClassActorThumbnailScene::GetSlotActor(int32 SlotIndex) const
+{
+	return SlotIndex == 0 ? PreviewActor.Get() : BatchPreviewActors[SlotIndex - 1].Get();
+}
+
 void FCustomClassActorThumbnailScene::ClearStaleActors()
 {
 	ULevel* Level = GetWorld()->GetCurrentLevel();
@@ -275,17 +575,22 @@ bool FCustomClassActorThumbnailScene::IsValidComponentForVisualization(const UAc
 }
 
 FBoxSphereBounds FCustomClassActorThumbnailScene::GetPreviewActorBounds() const
+{
+	return GetActorBounds(PreviewActor.Get());
+}
+
+FBoxSphereBounds FCustomClassActorThumbnailScene::GetActorBounds(const AActor* Actor)
 {
 #if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION <= 2
 	FBoxSphereBounds BoundsBuilder;
 #else
 	FBoxSphereBounds::Builder BoundsBuilder;
 #endif
-	if (PreviewActor.IsValid() && PreviewActor->GetRootComponent())
+	if (Actor && Actor->GetRootComponent())
 	{
 		TArray<USceneComponent*> PreviewComponents;
-		PreviewActor->GetRootComponent()->GetChildrenComponents(true, PreviewComponents);
-		PreviewComponents.Add(PreviewActor->GetRootComponent());
+		Actor->GetRootComponent()->GetChildrenComponents(true, PreviewComponents);
+		PreviewComponents.Add(Actor->GetRootComponent());
 
 		for (USceneComponent* PreviewComponent : PreviewComponents)
 		{
@@ -304,24 +609,40 @@ FBoxSphereBounds FCustomClassActorThumbnailScene::GetPreviewActorBounds() const
 }
 
 void FCustomClassActorThumbnailScene::GetViewMatrixParameters(const float InFOVDegrees, FVector& OutOrigin, float& OutOrbitPitch, float& OutOrbitYaw, float& OutOrbitZoom) const
+{
+	GetSlotViewMatrixParameters(0, InFOVDegrees, OutOrigin, OutOrbitPitch, OutOrbitYaw, OutOrbitZoom);
+}
+
+void FCustomClassActorThumbnailScene::GetSlotViewMatrixParameters(int32 SlotIndex, const float InFOVDegrees, FVector& OutOrigin, float& OutOrbitPitch, float& OutOrbitYaw, float& OutOrbitZoom) const
 {
 	const float HalfFOVRadians = FMath::DegreesToRadians<float>(InFOVDegrees) * 0.5f;
 	// Add extra size to view slightly outside of the sphere to compensate for perspective
-	const FBoxSphereBounds Bounds = GetPreviewActorBounds();
+	const FBoxSphereBounds Bounds = GetActorBounds(GetSlotActor(SlotIndex));
 
 	const float HalfMeshSize = static_cast<float>(Bounds.SphereRadius * 1.15);
 	const float BoundsZOffset = GetBoundsZOffset(Bounds);
 	const float TargetDistance = HalfMeshSize / FMath::Tan(HalfFOVRadians);
 
-	USceneThumbnailInfo* ThumbnailInfo = GetSceneThumbnailInfo(TargetDistance);
+	USceneThumbnailInfo* ThumbnailInfo = GetSlotSceneThumbnailInfo(SlotIndex, TargetDistance);
 	check(ThumbnailInfo);
 
-	OutOrigin = FVector(0, 0, -BoundsZOffset);
+	OutOrigin = FVector(0, 0, -BoundsZOffset) - GetSlotOffset(SlotIndex, NumSlots, SlotSpacing);
 	OutOrbitPitch = ThumbnailInfo->OrbitPitch;
 	OutOrbitYaw = ThumbnailInfo->OrbitYaw;
 	OutOrbitZoom = TargetDistance + ThumbnailInfo->OrbitZoom;
 }
 
+void FCustomClassActorThumbnailScene::GetSlotPrimitiveComponents(int32 SlotIndex, TArray<const UPrimitiveComponent*>& OutComponents) const
+{
+	if (const AActor* SlotActor = GetSlotActor(SlotIndex))
+	{
+		SlotActor->ForEachComponent<UPrimitiveComponent>(true, [&OutComponents](const UPrimitiveComponent* Component)
+		{
+			OutComponents.Add(Component);
+		});
+	}
+}
+
 /*
 ***************************************************************
   FBlueprintThumbnailScene
@@ -336,10 +657,29 @@ FCustomBlueprintThumbnailScene::FCustomBlueprintThumbnailScene()
 void FCustomBlueprintThumbnailScene::SetBlueprint(UBlueprint* Blueprint)
 {
 	CurrentBlueprint = Blueprint;
+	BatchBlueprints.Reset();
 	UClass* BPClass = (Blueprint ? Blueprint->GeneratedClass : nullptr);
 	SpawnPreviewActor(BPClass);
 }
 
+void FCustomBlueprintThumbnailScene::SetBlueprints(TArrayView<UBlueprint* const> Blueprints)
+{
+	CurrentBlueprint = Blueprints.Num() > 0 ? Blueprints[0] : nullptr;
+	BatchBlueprints.Reset();
+
+	TArray<UClass*> BPClasses;
+	for (int32 SlotIndex = 0; SlotIndex < Blueprints.Num(); ++SlotIndex)
+	{
+		UBlueprint* Blueprint = Blueprints[SlotIndex];
+		if (SlotIndex > 0)
+		{
+			BatchBlueprints.Add(Blueprint);
+		}
+		BPClasses.Add(Blueprint ? Blueprint->GeneratedClass : nullptr);
+	}
+	SpawnPreviewActors(BPClasses);
+}
+
 void FCustomBlueprintThumbnailScene::BlueprintChanged(UBlueprint* Blueprint)
 {
 	if (CurrentBlueprint == Blueprint)
@@ -351,7 +691,12 @@ void FCustomBlueprintThumbnailScene::BlueprintChanged(UBlueprint* Blueprint)
 
 USceneThumbnailInfo* FCustomBlueprintThumbnailScene::GetSceneThumbnailInfo(const float TargetDistance) const
 {
-	UBlueprint* Blueprint = CurrentBlueprint.Get();
+	return GetSlotSceneThumbnailInfo(0, TargetDistance);
+}
+
+USceneThumbnailInfo* FCustomBlueprintThumbnailScene::GetSlotSceneThumbnailInfo(int32 SlotIndex, const float TargetDistance) const
+{
+	UBlueprint* Blueprint = SlotIndex == 0 ? CurrentBlueprint.Get() : BatchBlueprints[SlotIndex - 1].Get();
 	check(Blueprint);
 
 	USceneThumbnailInfo* ThumbnailInfo = Cast<USceneThumbnailInfo>(Blueprint->ThumbnailInfo);
@@ -381,37 +726,79 @@ FCustomSkeletalMeshThumbnailScene::FCustomSkeletalMeshThumbnailScene()
 	bForceAllUsedMipsResident = false;
 	// Create preview actor
 	// checked
+	PreviewActor = SpawnPreviewActor();
+}
+
+ASkeletalMeshActor* FCustomSkeletalMeshThumbnailScene::SpawnPreviewActor()
+{
 	FActorSpawnParameters SpawnInfo;
 	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
 	SpawnInfo.bNoFail = true;
 	SpawnInfo.ObjectFlags = RF_Transient;
-	PreviewActor = GetWorld()->SpawnActor<ASkeletalMeshActor>( SpawnInfo );
+	ASkeletalMeshActor* NewActor = GetWorld()->SpawnActor<ASkeletalMeshActor>( SpawnInfo );
+
+	NewActor->SetActorEnableCollision(false);
+	return NewActor;
+}
 
-	PreviewActor->SetActorEnableCollision(false);
+ASkeletalMeshActor* FCustomSkeletalMeshThumbnailScene::GetSlotActor(int32 SlotIndex) const
+{
+	return SlotIndex == 0 ? PreviewActor : BatchPreviewActors[SlotIndex - 1];
 }
 
 void FCustomSkeletalMeshThumbnailScene::SetSkeletalMesh(USkeletalMesh* InSkeletalMesh)
 {
-	PreviewActor->GetSkeletalMeshComponent()->OverrideMaterials.Empty();
-	PreviewActor->GetSkeletalMeshComponent()->SetSkeletalMesh(InSkeletalMesh, false);
-	PreviewActor->GetSkeletalMeshComponent()->SetDrawDebugSkeleton(bDrawDebugSkeleton);
-	PreviewActor->GetSkeletalMeshComponent()->SetDebugDrawColor(DrawDebugColor);
+	SetSkeletalMeshes(MakeArrayView(&InSkeletalMesh, 1));
+}
+
+void FCustomSkeletalMeshThumbnailScene::SetSkeletalMeshes(TArrayView<USkeletalMesh* const> SkeletalMeshes)
+{
+	const int32 NewNumSlots = FMath::Max(1, SkeletalMeshes.Num());
+	while (BatchPreviewActors.Num() < NewNumSlots - 1)
+	{
+		BatchPreviewActors.Add(SpawnPreviewActor());
+	}
 
-	if ( InSkeletalMesh )
+	// Actors of the slots in excess keep no mesh, so they never show up
+	const int32 NumUsedSlots = FMath::Max(NumSlots, NewNumSlots);
+	NumSlots = NewNumSlots;
+
+	float MaxSphereRadius = 0.f;
+	for (int32 SlotIndex = 0; SlotIndex < NumUsedSlots; ++SlotIndex)
 	{
-		FTransform MeshTransform = FTransform::Identity;
+		ASkeletalMeshActor* SlotActor = GetSlotActor(SlotIndex);
+		USkeletalMesh* InSkeletalMesh = SkeletalMeshes.IsValidIndex(SlotIndex) ? SkeletalMeshes[SlotIndex] : nullptr;
 
-		PreviewActor->SetActorLocation(FVector(0,0,0), false);
-		PreviewActor->GetSkeletalMeshComponent()->UpdateBounds();
+		SlotActor->GetSkeletalMeshComponent()->OverrideMaterials.Empty();
+		SlotActor->GetSkeletalMeshComponent()->SetSkeletalMesh(InSkeletalMesh, false);
+		SlotActor->GetSkeletalMeshComponent()->SetDrawDebugSkeleton(bDrawDebugSkeleton);
+		SlotActor->GetSkeletalMeshComponent()->SetDebugDrawColor(DrawDebugColor);
 
-		// Center the mesh at the world origin then offset to put it on top of the plane
-		const float BoundsZOffset = GetBoundsZOffset(PreviewActor->GetSkeletalMeshComponent()->Bounds);
-		PreviewActor->SetActorLocation( -PreviewActor->GetSkeletalMeshComponent()->Bounds.Origin + FVector(0, 0, BoundsZOffset), false );
-		PreviewActor->GetSkeletalMeshComponent()->RecreateRenderState_Concurrent();
+		if ( InSkeletalMesh )
+		{
+			SlotActor->SetActorLocation(FVector(0,0,0), false);
+			SlotActor->GetSkeletalMeshComponent()->UpdateBounds();
+			MaxSphereRadius = FMath::Max(MaxSphereRadius, static_cast<float>(SlotActor->GetSkeletalMeshComponent()->Bounds.SphereRadius));
+		}
+		else
+		{
+			SlotActor->GetSkeletalMeshComponent()->ClearAnimScriptInstance();
+		}
 	}
-	else
+
+	SlotSpacing = GetSlotSpacing(MaxSphereRadius);
+	for (int32 SlotIndex = 0; SlotIndex < NumUsedSlots; ++SlotIndex)
 	{
-		PreviewActor->GetSkeletalMeshComponent()->ClearAnimScriptInstance();
+		ASkeletalMeshActor* SlotActor = GetSlotActor(SlotIndex);
+		if ( SlotIndex < NumSlots && SlotActor->GetSkeletalMeshComponent()->GetSkeletalMeshAsset() )
+		{
+			// Center the mesh at the world origin then offset to put it on top of the plane, and on its slot of the batch
+			const float BoundsZOffset = GetBoundsZOffset(SlotActor->GetSkeletalMeshComponent()->Bounds);
+			SlotActor->SetActorLocation( -SlotActor->GetSkeletalMeshComponent()->Bounds.Origin + FVector(0, 0, BoundsZOffset) + GetSlotOffset(SlotIndex, NumSlots, SlotSpacing), false );
+		}
+
+		// Only rebuilds the render state of the slots whose mesh changed, the others at most move
+		SlotActor->GetSkeletalMeshComponent()->DoDeferredRenderUpdates_Concurrent();
 	}
 }
 
@@ -419,25 +806,35 @@ void FCustomSkeletalMeshThumbnailScene::SetDrawDebugSkeleton(bool bInDrawDebugSk
 {
  	bDrawDebugSkeleton = bInDrawDebugSkeleton;
 	DrawDebugColor = InSkeletonColor;
-	PreviewActor->GetSkeletalMeshComponent()->SetDrawDebugSkeleton(bDrawDebugSkeleton);
-	PreviewActor->GetSkeletalMeshComponent()->SetDebugDrawColor(DrawDebugColor);
-	PreviewActor->GetSkeletalMeshComponent()->RecreateRenderState_Concurrent();
+	for (int32 SlotIndex = 0; SlotIndex <= BatchPreviewActors.Num(); ++SlotIndex)
+	{
+		ASkeletalMeshActor* SlotActor = GetSlotActor(SlotIndex);
+		SlotActor->GetSkeletalMeshComponent()->SetDrawDebugSkeleton(bDrawDebugSkeleton);
+		SlotActor->GetSkeletalMeshComponent()->SetDebugDrawColor(DrawDebugColor);
+		SlotActor->GetSkeletalMeshComponent()->RecreateRenderState_Concurrent();
+	}
 }
 
 void FCustomSkeletalMeshThumbnailScene::GetViewMatrixParameters(const float InFOVDegrees, FVector& OutOrigin, float& OutOrbitPitch, float& OutOrbitYaw, float& OutOrbitZoom) const
 {
-	check(PreviewActor->GetSkeletalMeshComponent());
+	GetSlotViewMatrixParameters(0, InFOVDegrees, OutOrigin, OutOrbitPitch, OutOrbitYaw, OutOrbitZoom);
+}
+
+void FCustomSkeletalMeshThumbnailScene::GetSlotViewMatrixParameters(int32 SlotIndex, const float InFOVDegrees, FVector& OutOrigin, float& OutOrbitPitch, float& OutOrbitYaw, float& OutOrbitZoom) const
+{
+	const USkeletalMeshComponent* SkeletalMeshComponent = GetSlotActor(SlotIndex)->GetSkeletalMeshComponent();
+	check(SkeletalMeshComponent);
 
 	const float HalfFOVRadians = FMath::DegreesToRadians<float>(InFOVDegrees) * 0.5f;
 	// No need to add extra size to view slightly outside of the sphere to compensate for perspective since skeletal meshes already buffer bounds.
-	const float HalfMeshSize = static_cast<float>(PreviewActor->GetSkeletalMeshComponent()->Bounds.SphereRadius); 
-	const float BoundsZOffset = GetBoundsZOffset(PreviewActor->GetSkeletalMeshComponent()->Bounds);
+	const float HalfMeshSize = static_cast<float>(SkeletalMeshComponent->Bounds.SphereRadius); 
+	const float BoundsZOffset = GetBoundsZOffset(SkeletalMeshComponent->Bounds);
 	const float TargetDistance = HalfMeshSize / FMath::Tan(HalfFOVRadians);
 
 	USceneThumbnailInfo* ThumbnailInfo = nullptr;
-	if(PreviewActor->GetSkeletalMeshComponent()->GetSkeletalMeshAsset())
+	if(SkeletalMeshComponent->GetSkeletalMeshAsset())
 	{
-		ThumbnailInfo = Cast<USceneThumbnailInfo>(PreviewActor->GetSkeletalMeshComponent()->GetSkeletalMeshAsset()->GetThumbnailInfo());
+		ThumbnailInfo = Cast<USceneThumbnailInfo>(SkeletalMeshComponent->GetSkeletalMeshAsset()->GetThumbnailInfo());
 	}
 	
 	if ( ThumbnailInfo )
@@ -452,12 +849,17 @@ void FCustomSkeletalMeshThumbnailScene::GetViewMatrixParameters(const float InFO
 		ThumbnailInfo = USceneThumbnailInfo::StaticClass()->GetDefaultObject<USceneThumbnailInfo>();
 	}
 
-	OutOrigin = FVector(0, 0, -BoundsZOffset);
+	OutOrigin = FVector(0, 0, -BoundsZOffset) - GetSlotOffset(SlotIndex, NumSlots, SlotSpacing);
 	OutOrbitPitch = ThumbnailInfo->OrbitPitch;
 	OutOrbitYaw = ThumbnailInfo->OrbitYaw;
 	OutOrbitZoom = TargetDistance + ThumbnailInfo->OrbitZoom;
 }
 
+void FCustomSkeletalMeshThumbnailScene::GetSlotPrimitiveComponents(int32 SlotIndex, TArray<const UPrimitiveComponent*>& OutComponents) const
+{
+	OutComponents.Add(GetSlotActor(SlotIndex)->GetSkeletalMeshComponent());
+}
+
 /*
 ***************************************************************
   FStaticMeshThumbnailScene
@@ -470,37 +872,78 @@ FCustomStaticMeshThumbnailScene::FCustomStaticMeshThumbnailScene()
 
 	// Create preview actor
 	// checked
+	PreviewActor = SpawnPreviewActor();
+}
+
+AStaticMeshActor* FCustomStaticMeshThumbnailScene::SpawnPreviewActor()
+{
 	FActorSpawnParameters SpawnInfo;
 	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
 	SpawnInfo.bNoFail = true;
 	SpawnInfo.ObjectFlags = RF_Transient;
-	PreviewActor = GetWorld()->SpawnActor<AStaticMeshActor>( SpawnInfo );
+	AStaticMeshActor* NewActor = GetWorld()->SpawnActor<AStaticMeshActor>( SpawnInfo );
+
+	NewActor->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+	NewActor->SetActorEnableCollision(false);
+	return NewActor;
+}
 
-	PreviewActor->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
-	PreviewActor->SetActorEnableCollision(false);
+AStaticMeshActor* FCustomStaticMeshThumbnailScene::GetSlotActor(int32 SlotIndex) const
+{
+	return SlotIndex == 0 ? PreviewActor : BatchPreviewActors[SlotIndex - 1];
 }
 
 void FCustomStaticMeshThumbnailScene::SetStaticMesh(UStaticMesh* StaticMesh)
 {
-	PreviewActor->GetStaticMeshComponent()->SetStaticMesh(StaticMesh);
+	SetStaticMeshes(MakeArrayView(&StaticMesh, 1));
+}
 
-	if ( StaticMesh )
+void FCustomStaticMeshThumbnailScene::SetStaticMeshes(TArrayView<UStaticMesh* const> StaticMeshes)
+{
+	const int32 NewNumSlots = FMath::Max(1, StaticMeshes.Num());
+	while (BatchPreviewActors.Num() < NewNumSlots - 1)
 	{
-		FTransform MeshTransform = FTransform::Identity;
+		BatchPreviewActors.Add(SpawnPreviewActor());
+	}
 
-		PreviewActor->SetActorLocation(FVector(0,0,0), false);
-		
-		//Force LOD 0
-		PreviewActor->GetStaticMeshComponent()->ForcedLodModel = 1;
+	// Actors of the slots in excess keep no mesh, so they never show up
+	const int32 NumUsedSlots = FMath::Max(NumSlots, NewNumSlots);
+	NumSlots = NewNumSlots;
+
+	float MaxSphereRadius = 0.f;
+	for (int32 SlotIndex = 0; SlotIndex < NumUsedSlots; ++SlotIndex)
+	{
+		AStaticMeshActor* SlotActor = GetSlotActor(SlotIndex);
+		UStaticMesh* StaticMesh = StaticMeshes.IsValidIndex(SlotIndex) ? StaticMeshes[SlotIndex] : nullptr;
+
+		SlotActor->GetStaticMeshComponent()->SetStaticMesh(StaticMesh);
+
+		if ( StaticMesh )
+		{
+			SlotActor->SetActorLocation(FVector(0,0,0), false);
 
-		PreviewActor->GetStaticMeshComponent()->UpdateBounds();
+			//Force LOD 0
+			SlotActor->GetStaticMeshComponent()->ForcedLodModel = 1;
 
-		// Center the mesh at the world origin then offset to put it on top of the plane
-		const float BoundsZOffset = GetBoundsZOffset(PreviewActor->GetStaticMeshComponent()->Bounds);
-		PreviewActor->SetActorLocation( -PreviewActor->GetStaticMeshComponent()->Bounds.Origin + FVector(0, 0, BoundsZOffset), false );
+			SlotActor->GetStaticMeshComponent()->UpdateBounds();
+			MaxSphereRadius = FMath::Max(MaxSphereRadius, static_cast<float>(SlotActor->GetStaticMeshComponent()->Bounds.SphereRadius));
+		}
 	}
 
-	PreviewActor->GetStaticMeshComponent()->RecreateRenderState_Concurrent();
+	SlotSpacing = GetSlotSpacing(MaxSphereRadius);
+	for (int32 SlotIndex = 0; SlotIndex < NumUsedSlots; ++SlotIndex)
+	{
+		AStaticMeshActor* SlotActor = GetSlotActor(SlotIndex);
+		if ( SlotIndex < NumSlots && SlotActor->GetStaticMeshComponent()->GetStaticMesh() )
+		{
+			// Center the mesh at the world origin then offset to put it on top of the plane, and on its slot of the batch
+			const float BoundsZOffset = GetBoundsZOffset(SlotActor->GetStaticMeshComponent()->Bounds);
+			SlotActor->SetActorLocation( -SlotActor->GetStaticMeshComponent()->Bounds.Origin + FVector(0, 0, BoundsZOffset) + GetSlotOffset(SlotIndex, NumSlots, SlotSpacing), false );
+		}
+
+		// Only rebuilds the render state of the slots whose mesh changed, the others at most move
+		SlotActor->GetStaticMeshComponent()->DoDeferredRenderUpdates_Concurrent();
+	}
 }
 
 void FCustomStaticMeshThumbnailScene::SetOverrideMaterials(const TArray<class UMaterialInterface*>& OverrideMaterials)
@@ -511,17 +954,23 @@ void FCustomStaticMeshThumbnailScene::SetOverrideMaterials(const TArray<class UM
 
 void FCustomStaticMeshThumbnailScene::GetViewMatrixParameters(const float InFOVDegrees, FVector& OutOrigin, float& OutOrbitPitch, float& OutOrbitYaw, float& OutOrbitZoom) const
 {
-	check(PreviewActor);
-	check(PreviewActor->GetStaticMeshComponent());
-	check(PreviewActor->GetStaticMeshComponent()->GetStaticMesh());
+	GetSlotViewMatrixParameters(0, InFOVDegrees, OutOrigin, OutOrbitPitch, OutOrbitYaw, OutOrbitZoom);
+}
+
+void FCustomStaticMeshThumbnailScene::GetSlotViewMatrixParameters(int32 SlotIndex, const float InFOVDegrees, FVector& OutOrigin, float& OutOrbitPitch, float& OutOrbitYaw, float& OutOrbitZoom) const
+{
+	const AStaticMeshActor* SlotActor = GetSlotActor(SlotIndex);
+	check(SlotActor);
+	check(SlotActor->GetStaticMeshComponent());
+	check(SlotActor->GetStaticMeshComponent()->GetStaticMesh());
 
 	const float HalfFOVRadians = FMath::DegreesToRadians<float>(InFOVDegrees) * 0.5f;
 	// Add extra size to view slightly outside of the sphere to compensate for perspective
-	const float HalfMeshSize = static_cast<float>(PreviewActor->GetStaticMeshComponent()->Bounds.SphereRadius * 1.15);
-	const float BoundsZOffset = GetBoundsZOffset(PreviewActor->GetStaticMeshComponent()->Bounds);
+	const float HalfMeshSize = static_cast<float>(SlotActor->GetStaticMeshComponent()->Bounds.SphereRadius * 1.15);
+	const float BoundsZOffset = GetBoundsZOffset(SlotActor->GetStaticMeshComponent()->Bounds);
 	const float TargetDistance = HalfMeshSize / FMath::Tan(HalfFOVRadians);
 
-	USceneThumbnailInfo* ThumbnailInfo = Cast<USceneThumbnailInfo>(PreviewActor->GetStaticMeshComponent()->GetStaticMesh()->ThumbnailInfo);
+	USceneThumbnailInfo* ThumbnailInfo = Cast<USceneThumbnailInfo>(SlotActor->GetStaticMeshComponent()->GetStaticMesh()->ThumbnailInfo);
 	if ( ThumbnailInfo )
 	{
 		if ( TargetDistance + ThumbnailInfo->OrbitZoom < 0 )
@@ -534,10 +983,13 @@ void FCustomStaticMeshThumbnailScene::GetViewMatrixParameters(const float InFOVD
 		ThumbnailInfo = USceneThumbnailInfo::StaticClass()->GetDefaultObject<USceneThumbnailInfo>();
 	}
 
-	OutOrigin = FVector(0, 0, -BoundsZOffset);
+	OutOrigin = FVector(0, 0, -BoundsZOffset) - GetSlotOffset(SlotIndex, NumSlots, SlotSpacing);
 	OutOrbitPitch = ThumbnailInfo->OrbitPitch;
 	OutOrbitYaw = ThumbnailInfo->OrbitYaw;
 	OutOrbitZoom = TargetDistance + ThumbnailInfo->OrbitZoom;
 }
 
-
+void FCustomStaticMeshThumbnailScene::GetSlotPrimitiveComponents(int32 SlotIndex, TArray<const UPrimitiveComponent*>& OutComponents) const
+{
+	OutComponents.Add(GetSlotActor(SlotIndex)->GetStaticMeshComponent());
+}
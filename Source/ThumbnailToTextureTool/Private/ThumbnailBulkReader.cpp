@@ -0,0 +1,122 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailBulkReader.h"
+
+#include "Async/MappedFileHandle.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Modules/ModuleManager.h"
+#include "Serialization/LargeMemoryReader.h"
+#include "UObject/PackageFileSummary.h"
+
+namespace ThumbnailBulkReader
+{
+	/** Reads the thumbnails of the given reads, all from the same package. Same parsing as ThumbnailTools::LoadThumbnailsFromPackage() */
+	void ReadPackage(const FString& PackageFilename, TArrayView<FCachedThumbnailRead* const> PackageReads)
+	{
+		// Mapping only pages in what is read, the bulk data of big packages is never touched
+		TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*PackageFilename));
+		TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile ? MappedFile->MapRegion() : nullptr);
+
+		TUniquePtr<FArchive> Reader;
+		if (MappedRegion)
+		{
+			Reader = MakeUnique<FLargeMemoryReader>(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize());
+		}
+		else
+		{
+			// Platforms and files that can't be mapped
+			Reader.Reset(IFileManager::Get().CreateFileReader(*PackageFilename));
+		}
+
+		if (!Reader)
+		{
+			return;
+		}
+
+		FPackageFileSummary Summary;
+		*Reader << Summary;
+		if (Reader->IsError() || Summary.Tag != PACKAGE_FILE_TAG || Summary.ThumbnailTableOffset <= 0
+			|| Summary.ThumbnailTableOffset >= Reader->TotalSize())
+		{
+			return;
+		}
+
+		// Thumbnails are serialized with the versions the package was saved with
+		Reader->SetUEVer(Summary.GetFileVersionUE());
+		Reader->SetLicenseeUEVer(Summary.GetFileVersionLicenseeUE());
+		Reader->SetCustomVersions(Summary.GetCustomVersionContainer());
+
+		Reader->Seek(Summary.ThumbnailTableOffset);
+		int32 NumThumbnails = 0;
+		*Reader << NumThumbnails;
+
+		TArray<int32, TInlineAllocator<4>> ThumbnailOffsets;
+		ThumbnailOffsets.Init(INDEX_NONE, PackageReads.Num());
+		for (int32 ThumbnailIndex = 0; ThumbnailIndex < NumThumbnails && !Reader->IsError(); ++ThumbnailIndex)
+		{
+			FString ObjectClassName;
+			FString ObjectPathWithoutPackageName;
+			int32 FileOffset = 0;
+			*Reader << ObjectClassName;
+			*Reader << ObjectPathWithoutPackageName;
+			*Reader << FileOffset;
+
+			for (int32 ReadIndex = 0; ReadIndex < PackageReads.Num(); ++ReadIndex)
+			{
+				if (PackageReads[ReadIndex]->ObjectPathInPackage == ObjectPathWithoutPackageName)
+				{
+					ThumbnailOffsets[ReadIndex] = FileOffset;
+				}
+			}
+		}
+
+		if (Reader->IsError())
+		{
+			return;
+		}
+
+		for (int32 ReadIndex = 0; ReadIndex < PackageReads.Num(); ++ReadIndex)
+		{
+			if (ThumbnailOffsets[ReadIndex] <= 0 || ThumbnailOffsets[ReadIndex] >= Reader->TotalSize())
+			{
+				continue;
+			}
+
+			FCachedThumbnailRead& Read = *PackageReads[ReadIndex];
+			Reader->Seek(ThumbnailOffsets[ReadIndex]);
+			Read.Thumbnail.Serialize(*Reader);
+			if (Reader->IsError() || Read.Thumbnail.IsEmpty())
+			{
+				Reader->ClearError();
+				continue;
+			}
+
+			// Decompress on this worker rather than when the texture is filled, then drop the compressed copy
+			Read.Thumbnail.GetUncompressedImageData();
+			Read.Thumbnail.AccessCompressedImageData().Empty();
+			Read.bFound = Read.Thumbnail.GetUncompressedImageData().Num() > 0;
+		}
+	}
+}
+
+void ThumbnailBulkReader::ReadThumbnails(TArrayView<FCachedThumbnailRead> Reads)
+{
+	TMap<FString, TArray<FCachedThumbnailRead*>> ReadsByPackage;
+	for (FCachedThumbnailRead& Read : Reads)
+	{
+		Read.bFound = false;
+		ReadsByPackage.FindOrAdd(Read.PackageFilename).Add(&Read);
+	}
+
+	TArray<TPair<FString, TArray<FCachedThumbnailRead*>>> Packages = ReadsByPackage.Array();
+
+	// The thumbnail compressors use the image wrapper module, which can only be loaded from the game thread
+	FModuleManager::Get().LoadModule(TEXT("ImageWrapper"));
+
+	ParallelFor(Packages.Num(), [&Packages](int32 PackageIndex)
+	{
+		ReadPackage(Packages[PackageIndex].Key, Packages[PackageIndex].Value);
+	});
+}
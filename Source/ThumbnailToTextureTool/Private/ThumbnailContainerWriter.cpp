@@ -0,0 +1,243 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailContainerWriter.h"
+
+#include "ThumbnailImageWriter.h"
+#include "ThumbnailToTextureExporter.h"
+#include "ThumbnailToTextureStats.h"
+#include "Algo/Sort.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+
+namespace ThumbnailContainerWriter
+{
+	EThumbnailOutputFormat ToOutputFormat(EThumbnailContainerEntryFormat Format)
+	{
+		switch (Format)
+		{
+		case EThumbnailContainerEntryFormat::PNG:
+			return EThumbnailOutputFormat::PNG;
+		case EThumbnailContainerEntryFormat::JPEG:
+			return EThumbnailOutputFormat::JPEG;
+		default:
+			return EThumbnailOutputFormat::Texture2D;
+		}
+	}
+}
+
+FThumbnailContainerWriter::FThumbnailContainerWriter(const FString& InFilename, EThumbnailContainerEntryFormat InFormat)
+	: Filename(InFilename)
+	, Format(InFormat)
+	, EndOffset(0)
+	, IndexEndOffset(0)
+	, Pipe(TEXT("ThumbnailContainerWriter"))
+{
+}
+
+FThumbnailContainerWriter::~FThumbnailContainerWriter()
+{
+	if (File.IsValid())
+	{
+		Rollback();
+	}
+}
+
+bool FThumbnailContainerWriter::Open()
+{
+	check(!File.IsValid());
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	// The entries of an existing container are kept when it ends with a valid index, the reader is closed before writing
+	bool bKeepExisting = false;
+	{
+		FThumbnailContainerReader Reader;
+		if (Reader.Open(Filename))
+		{
+			for (const FThumbnailContainerIndexEntry& Entry : Reader.GetIndex())
+			{
+				CommittedEntries.Add(Entry.PathHash, Entry);
+			}
+			bKeepExisting = true;
+		}
+		else if (PlatformFile.FileExists(*Filename))
+		{
+			UE_LOG(LogThumbnailToTexture, Warning, TEXT("%s isn't a valid thumbnail container, it is started over"), *Filename);
+		}
+	}
+
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Filename));
+	// Readers can keep the last committed index open while the entries are appended after it
+	constexpr bool bAllowRead = true;
+	File.Reset(PlatformFile.OpenWrite(*Filename, bKeepExisting, bAllowRead));
+	if (!File.IsValid())
+	{
+		UE_LOG(LogThumbnailToTexture, Error, TEXT("Couldn't open %s for writing"), *Filename);
+		CommittedEntries.Reset();
+		return false;
+	}
+
+	EndOffset = File->Size();
+
+	// A new container gets an index even if nothing is added, so it can be opened
+	IndexEndOffset = bKeepExisting ? EndOffset : -1;
+	return true;
+}
+
+UE::Tasks::TTask<bool> FThumbnailContainerWriter::Add(FStringView AssetPath, FIntPoint Size, TArray<FColor>&& Pixels)
+{
+	check(IsInGameThread());
+	check(Pixels.Num() == Size.X * Size.Y);
+
+	if (!File.IsValid() || Size.X > MAX_uint16 || Size.Y > MAX_uint16)
+	{
+		return UE::Tasks::Launch(UE_SOURCE_LOCATION, [] { return false; });
+	}
+
+	const EThumbnailContainerEntryFormat EntryFormat = Format;
+	if (EntryFormat != EThumbnailContainerEntryFormat::BGRA8)
+	{
+		ThumbnailImageWriter::LoadImageWrappers();
+	}
+
+	UE::Tasks::TTask<TArray64<uint8>> Encode = UE::Tasks::Launch(UE_SOURCE_LOCATION, [EntryFormat, Size, Pixels = MoveTemp(Pixels)]() mutable
+	{
+		THUMBNAILTOTEXTURE_SCOPE(ImageWrite);
+
+		TArray64<uint8> EntryData;
+		if (EntryFormat == EThumbnailContainerEntryFormat::BGRA8)
+		{
+			EntryData.Append(reinterpret_cast<const uint8*>(Pixels.GetData()), Pixels.Num() * sizeof(FColor));
+		}
+		else if (!ThumbnailImageWriter::Encode(ThumbnailContainerWriter::ToOutputFormat(EntryFormat), Size, Pixels, EntryData))
+		{
+			EntryData.Empty();
+		}
+
+		// Only the stored bytes are kept until they're appended
+		Pixels.Empty();
+		return EntryData;
+	});
+
+	const uint64 PathHash = ThumbnailContainer::HashAssetPath(AssetPath);
+	UE::Tasks::TTask<bool> AppendTask = Pipe.Launch(UE_SOURCE_LOCATION, [this, PathHash, Size, Encode]() mutable
+	{
+		TArray64<uint8>& EntryData = Encode.GetResult();
+		const bool bAppended = EntryData.Num() > 0 && Append(PathHash, Size, EntryData);
+		EntryData.Empty();
+		return bAppended;
+	}, UE::Tasks::Prerequisites(Encode));
+
+	PendingAppends.Add(AppendTask);
+	return AppendTask;
+}
+
+bool FThumbnailContainerWriter::Append(uint64 PathHash, FIntPoint Size, const TArray64<uint8>& EntryData)
+{
+	if (EntryData.Num() > MAX_uint32 || !AlignEnd())
+	{
+		return false;
+	}
+
+	if (!File->Write(EntryData.GetData(), EntryData.Num()))
+	{
+		// The next entry is aligned after whatever made it to the file
+		EndOffset = File->Tell();
+		return false;
+	}
+
+	FThumbnailContainerIndexEntry& Entry = AddedEntries.AddDefaulted_GetRef();
+	Entry.PathHash = PathHash;
+	Entry.Offset = EndOffset;
+	Entry.Size = static_cast<uint32>(EntryData.Num());
+	Entry.Width = static_cast<uint16>(Size.X);
+	Entry.Height = static_cast<uint16>(Size.Y);
+	Entry.Format = static_cast<uint8>(Format);
+
+	EndOffset += EntryData.Num();
+	return true;
+}
+
+bool FThumbnailContainerWriter::AlignEnd()
+{
+	static const uint8 Zeros[ThumbnailContainer::Alignment] = {};
+	const int64 NumPaddingBytes = Align(EndOffset, ThumbnailContainer::Alignment) - EndOffset;
+	if (NumPaddingBytes > 0 && !File->Write(Zeros, NumPaddingBytes))
+	{
+		EndOffset = File->Tell();
+		return false;
+	}
+
+	EndOffset += NumPaddingBytes;
+	return true;
+}
+
+bool FThumbnailContainerWriter::Contains(FStringView AssetPath) const
+{
+	return CommittedEntries.Contains(ThumbnailContainer::HashAssetPath(AssetPath));
+}
+
+bool FThumbnailContainerWriter::Commit()
+{
+	UE::Tasks::Wait(PendingAppends);
+	PendingAppends.Reset();
+
+	// Later entries of an asset replace the earlier ones
+	for (const FThumbnailContainerIndexEntry& Entry : AddedEntries)
+	{
+		CommittedEntries.Add(Entry.PathHash, Entry);
+	}
+	AddedEntries.Reset();
+
+	return WriteIndex();
+}
+
+bool FThumbnailContainerWriter::Rollback()
+{
+	UE::Tasks::Wait(PendingAppends);
+	PendingAppends.Reset();
+	AddedEntries.Reset();
+
+	return WriteIndex();
+}
+
+bool FThumbnailContainerWriter::WriteIndex()
+{
+	if (!File.IsValid())
+	{
+		return false;
+	}
+
+	// The file still ends with the last index
+	if (EndOffset == IndexEndOffset)
+	{
+		return true;
+	}
+
+	TArray<FThumbnailContainerIndexEntry> Index;
+	CommittedEntries.GenerateValueArray(Index);
+	Algo::SortBy(Index, &FThumbnailContainerIndexEntry::PathHash);
+
+	if (!AlignEnd())
+	{
+		return false;
+	}
+
+	FThumbnailContainerTrailer Trailer;
+	Trailer.IndexOffset = EndOffset;
+	Trailer.NumEntries = Index.Num();
+
+	const int64 IndexSize = Index.Num() * sizeof(FThumbnailContainerIndexEntry);
+	if ((IndexSize > 0 && !File->Write(reinterpret_cast<const uint8*>(Index.GetData()), IndexSize))
+		|| !File->Write(reinterpret_cast<const uint8*>(&Trailer), sizeof(Trailer))
+		|| !File->Flush())
+	{
+		UE_LOG(LogThumbnailToTexture, Error, TEXT("Failed to write the index of %s"), *Filename);
+		EndOffset = File->Tell();
+		return false;
+	}
+
+	EndOffset += IndexSize + sizeof(Trailer);
+	IndexEndOffset = EndOffset;
+	return true;
+}
@@ -0,0 +1,60 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailDerivedData.h"
+
+#include "DerivedDataCacheInterface.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace ThumbnailDerivedData
+{
+	/** Change when the layout of the cached data changes, every entry is then rendered again */
+	const TCHAR* const Version = TEXT("9B2E4A71C35D4F0E8A6B1D7C20F3E845");
+
+	/** Rejects corrupted entries before allocating their pixels */
+	constexpr int32 MaxDimension = 16384;
+}
+
+FString ThumbnailDerivedData::BuildKey(const FString& InputHash)
+{
+	return FDerivedDataCacheInterface::BuildCacheKey(TEXT("THUMBTOTEX"), Version, *InputHash);
+}
+
+bool ThumbnailDerivedData::Get(const FString& Key, FStringView DebugContext, FIntPoint& OutSize, TArray<FColor>& OutPixels)
+{
+	TArray<uint8> Data;
+	if (!GetDerivedDataCacheRef().GetSynchronous(*Key, Data, DebugContext))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+	Reader << SizeX << SizeY;
+
+	const int64 NumBytes = static_cast<int64>(SizeX) * SizeY * sizeof(FColor);
+	if (Reader.IsError() || SizeX <= 0 || SizeY <= 0 || SizeX > MaxDimension || SizeY > MaxDimension
+		|| Reader.TotalSize() - Reader.Tell() != NumBytes)
+	{
+		return false;
+	}
+
+	OutSize = FIntPoint(SizeX, SizeY);
+	OutPixels.SetNumUninitialized(SizeX * SizeY);
+	Reader.Serialize(OutPixels.GetData(), NumBytes);
+	return !Reader.IsError();
+}
+
+void ThumbnailDerivedData::Put(const FString& Key, FStringView DebugContext, FIntPoint Size, const FColor* Pixels)
+{
+	const int64 NumBytes = static_cast<int64>(Size.X) * Size.Y * sizeof(FColor);
+
+	TArray<uint8> Data;
+	Data.Reserve(2 * sizeof(int32) + NumBytes);
+	FMemoryWriter Writer(Data);
+	Writer << Size.X << Size.Y;
+	Writer.Serialize(const_cast<FColor*>(Pixels), NumBytes);
+
+	GetDerivedDataCacheRef().Put(*Key, Data, DebugContext);
+}
@@ -0,0 +1,135 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailExportManifest.h"
+
+#include "ThumbnailToTextureExporter.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace ThumbnailExportManifest
+{
+	/** Bump when the file layout changes */
+	constexpr int32 Version = 1;
+}
+
+FThumbnailExportManifest::FThumbnailExportManifest(const FString& InFilename)
+	: Filename(InFilename)
+	, bModified(false)
+{
+}
+
+FString FThumbnailExportManifest::GetDefaultFilename()
+{
+	return FPaths::ProjectSavedDir() / TEXT("ThumbnailToTexture") / TEXT("ExportManifest.json");
+}
+
+bool FThumbnailExportManifest::Load()
+{
+	Entries.Reset();
+	bModified = false;
+
+	FString Json;
+	if (!FFileHelper::LoadFileToString(Json, *Filename))
+	{
+		// First run
+		return true;
+	}
+
+	TSharedPtr<FJsonObject> Root;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid())
+	{
+		UE_LOG(LogThumbnailToTexture, Warning, TEXT("Couldn't parse the export manifest %s, every asset will be exported"), *Filename);
+		return false;
+	}
+
+	if (Root->GetIntegerField(TEXT("Version")) != ThumbnailExportManifest::Version)
+	{
+		UE_LOG(LogThumbnailToTexture, Display, TEXT("The export manifest %s is from another version, every asset will be exported"), *Filename);
+		return true;
+	}
+
+	const TSharedPtr<FJsonObject>* Assets = nullptr;
+	if (Root->TryGetObjectField(TEXT("Assets"), Assets))
+	{
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : (*Assets)->Values)
+		{
+			const TSharedPtr<FJsonObject>* EntryObject = nullptr;
+			if (Pair.Value->TryGetObject(EntryObject))
+			{
+				FEntry& Entry = Entries.Add(Pair.Key);
+				Entry.InputHash = (*EntryObject)->GetStringField(TEXT("InputHash"));
+				Entry.TexturePackageName = (*EntryObject)->GetStringField(TEXT("Texture"));
+			}
+		}
+	}
+
+	return true;
+}
+
+bool FThumbnailExportManifest::Save()
+{
+	if (!bModified)
+	{
+		return true;
+	}
+
+	// Sorted so the file diffs nicely when it is kept in source control
+	Entries.KeySort(TLess<FString>());
+
+	const TSharedRef<FJsonObject> Assets = MakeShared<FJsonObject>();
+	for (const TPair<FString, FEntry>& Pair : Entries)
+	{
+		const TSharedRef<FJsonObject> EntryObject = MakeShared<FJsonObject>();
+		EntryObject->SetStringField(TEXT("InputHash"), Pair.Value.InputHash);
+		EntryObject->SetStringField(TEXT("Texture"), Pair.Value.TexturePackageName);
+		Assets->SetObjectField(Pair.Key, EntryObject);
+	}
+
+	const TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetNumberField(TEXT("Version"), ThumbnailExportManifest::Version);
+	Root->SetObjectField(TEXT("Assets"), Assets);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	if (!FJsonSerializer::Serialize(Root, Writer) || !FFileHelper::SaveStringToFile(Json, *Filename))
+	{
+		UE_LOG(LogThumbnailToTexture, Warning, TEXT("Couldn't write the export manifest %s"), *Filename);
+		return false;
+	}
+
+	bModified = false;
+	return true;
+}
+
+bool FThumbnailExportManifest::IsUpToDate(const FString& SourceAssetPath, const FString& InputHash, const FString& TexturePackageName) const
+{
+	const FEntry* Entry = Entries.Find(SourceAssetPath);
+	return Entry
+		&& Entry->InputHash == InputHash
+		&& Entry->TexturePackageName == TexturePackageName
+		&& (FPackageName::IsValidLongPackageName(TexturePackageName)
+			? FPackageName::DoesPackageExist(TexturePackageName)
+			: IFileManager::Get().FileExists(*TexturePackageName));
+}
+
+void FThumbnailExportManifest::Record(const FString& SourceAssetPath, const FString& InputHash, const FString& TexturePackageName)
+{
+	FEntry& Entry = Entries.FindOrAdd(SourceAssetPath);
+	Entry.InputHash = InputHash;
+	Entry.TexturePackageName = TexturePackageName;
+	bModified = true;
+}
+
+void FThumbnailExportManifest::Remove(const FString& SourceAssetPath)
+{
+	if (Entries.Remove(SourceAssetPath) > 0)
+	{
+		bModified = true;
+	}
+}
@@ -0,0 +1,146 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailExportTask.h"
+
+#include "IThumbnailToTextureTool.h"
+#include "ThumbnailToTextureSettings.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "Widgets/Notifications/SNotificationList.h"
+
+#define LOCTEXT_NAMESPACE "ThumbnailExportTask"
+
+FThumbnailExportTask::FThumbnailExportTask(const TArray<FAssetData>& InAssets)
+	: Assets(InAssets)
+	, NextAssetIndex(0)
+	, Exporter(MakeUnique<FThumbnailToTextureExporter>())
+	, StartTime(FPlatformTime::Seconds())
+	, bFinished(false)
+{
+	Exporter->BeginExport(Assets.Num(), Stats);
+
+	FNotificationInfo Info(LOCTEXT("ExportStarting", "Exporting thumbnails..."));
+	Info.bFireAndForget = false;
+	Info.ExpireDuration = 3.0f;
+	Info.ButtonDetails.Add(FNotificationButtonInfo(
+		LOCTEXT("CancelExport", "Cancel"),
+		LOCTEXT("CancelExportTooltip", "Stops the export, the textures that weren't saved yet are discarded"),
+		FSimpleDelegate::CreateRaw(this, &FThumbnailExportTask::Cancel),
+		SNotificationItem::CS_Pending));
+
+	Notification = FSlateNotificationManager::Get().AddNotification(Info);
+	if (Notification.IsValid())
+	{
+		Notification->SetCompletionState(SNotificationItem::CS_Pending);
+	}
+}
+
+FThumbnailExportTask::~FThumbnailExportTask()
+{
+	Cancel();
+}
+
+void FThumbnailExportTask::Cancel()
+{
+	if (bFinished)
+	{
+		return;
+	}
+
+	Exporter->CancelPendingExports();
+	Finish(true);
+}
+
+void FThumbnailExportTask::Tick(float DeltaTime)
+{
+	const double BudgetSeconds = IThumbnailToTextureToolModule::GetEditorSettings().ExportFrameBudgetMs / 1000.0;
+	const double TickStartTime = FPlatformTime::Seconds();
+
+	// At least one asset per frame, however slow it is
+	while (NextAssetIndex < Assets.Num())
+	{
+		Exporter->ExportAsset(Assets[NextAssetIndex++], Stats);
+		if (FPlatformTime::Seconds() - TickStartTime >= BudgetSeconds)
+		{
+			break;
+		}
+	}
+
+	if (NextAssetIndex < Assets.Num())
+	{
+		UpdateNotification();
+		return;
+	}
+
+	// Assets waiting for their shaders are drawn over the next frames instead of blocking the editor until they compile
+	if (const int32 NumDeferredRenders = Exporter->GetNumDeferredRenders(); NumDeferredRenders > 0)
+	{
+		Exporter->UpdateDeferredRenders();
+		if (Notification.IsValid())
+		{
+			Notification->SetText(FText::Format(LOCTEXT("ExportWaitingForShaders", "Waiting for the shaders of {0} assets to compile..."), FText::AsNumber(NumDeferredRenders)));
+		}
+		return;
+	}
+
+	// Renders still in flight are read back, then the packages are saved in one go
+	if (Notification.IsValid())
+	{
+		Notification->SetText(FText::Format(LOCTEXT("ExportSaving", "Saving {0} thumbnail textures..."), FText::AsNumber(Stats.NumExported)));
+	}
+	Exporter->FinishExport(Stats);
+	Finish(false);
+}
+
+TStatId FThumbnailExportTask::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FThumbnailExportTask, STATGROUP_Tickables);
+}
+
+void FThumbnailExportTask::UpdateNotification()
+{
+	if (!Notification.IsValid() || NextAssetIndex == 0)
+	{
+		return;
+	}
+
+	const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+	const double SecondsLeft = ElapsedSeconds / NextAssetIndex * (Assets.Num() - NextAssetIndex);
+
+	Notification->SetText(FText::Format(LOCTEXT("ExportProgress", "Exporting thumbnails {0}/{1}, {2} left"),
+		FText::AsNumber(NextAssetIndex), FText::AsNumber(Assets.Num()), FText::AsTimespan(FTimespan::FromSeconds(SecondsLeft))));
+}
+
+void FThumbnailExportTask::Finish(bool bCancelled)
+{
+	bFinished = true;
+
+	// Nothing references the exported assets anymore, its render targets and container go too
+	Exporter.Reset();
+
+	if (bCancelled)
+	{
+		UE_LOG(LogThumbnailToTexture, Display, TEXT("Thumbnail export cancelled after %d of %d assets, unsaved textures were discarded"), NextAssetIndex, Assets.Num());
+	}
+	else
+	{
+		Stats.LogSummary();
+	}
+
+	if (Notification.IsValid())
+	{
+		if (bCancelled)
+		{
+			Notification->SetText(LOCTEXT("ExportCancelled", "Thumbnail export cancelled"));
+		}
+		else
+		{
+			Notification->SetText(FText::Format(LOCTEXT("ExportDone", "Exported {0} thumbnails, {1} failed"),
+				FText::AsNumber(Stats.NumExported), FText::AsNumber(Stats.NumFailed)));
+		}
+		Notification->SetCompletionState(bCancelled || Stats.NumFailed > 0 ? SNotificationItem::CS_Fail : SNotificationItem::CS_Success);
+		Notification->ExpireAndFadeout();
+		Notification.Reset();
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,341 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailImageUtils.h"
+
+#include "Async/ParallelFor.h"
+
+namespace ThumbnailImageUtils
+{
+	/** Pixels keyed by one task of KeyBackground() */
+	constexpr int32 KeyingPixelsPerTask = 64 * 1024;
+
+	FORCEINLINE bool IsKeyed(const FColor& Pixel, const FThumbnailKeyingParams& Params)
+	{
+		return Pixel.B >= Params.Min.B && Pixel.B <= Params.Max.B
+			&& Pixel.G >= Params.Min.G && Pixel.G <= Params.Max.G
+			&& Pixel.R >= Params.Min.R && Pixel.R <= Params.Max.R
+			&& Pixel.A >= Params.Min.A && Pixel.A <= Params.Max.A;
+	}
+
+	/** Writes the keyed pixels of a range to Dest, which can be Src. Only the Transparent mode keys, the others copy */
+	template<EThumbnailBackgroundMode Mode>
+	void KeyPixels(const FColor* Src, FColor* Dest, int32 NumPixels, const FThumbnailKeyingParams& Params)
+	{
+		if constexpr (Mode != EThumbnailBackgroundMode::Transparent)
+		{
+			if (Src != Dest)
+			{
+				FMemory::Memcpy(Dest, Src, NumPixels * sizeof(FColor));
+			}
+		}
+		else if (!Params.bCanMatch)
+		{
+			if (Src != Dest)
+			{
+				FMemory::Memcpy(Dest, Src, NumPixels * sizeof(FColor));
+			}
+		}
+		else
+		{
+			int32 Index = 0;
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+			const uint8x16_t Min = vreinterpretq_u8_u32(vdupq_n_u32(Params.Min.DWColor()));
+			const uint8x16_t Max = vreinterpretq_u8_u32(vdupq_n_u32(Params.Max.DWColor()));
+			const uint8x16_t AlphaMask = vreinterpretq_u8_u32(vdupq_n_u32(FColor(0, 0, 0, 255).DWColor()));
+			for (; Index + 4 <= NumPixels; Index += 4)
+			{
+				const uint8x16_t Pixel = vld1q_u8(reinterpret_cast<const uint8*>(Src + Index));
+
+				// A channel is in range when clamping it doesn't change it, a pixel when its 4 channels are
+				const uint8x16_t InRange = vceqq_u8(vminq_u8(vmaxq_u8(Pixel, Min), Max), Pixel);
+				const uint8x16_t Keyed = vreinterpretq_u8_u32(vceqq_u32(vreinterpretq_u32_u8(InRange), vdupq_n_u32(0xFFFFFFFF)));
+				vst1q_u8(reinterpret_cast<uint8*>(Dest + Index), vbicq_u8(Pixel, vandq_u8(Keyed, AlphaMask)));
+			}
+#elif PLATFORM_ENABLE_VECTORINTRINSICS
+			const __m128i Min = _mm_set1_epi32(static_cast<int32>(Params.Min.DWColor()));
+			const __m128i Max = _mm_set1_epi32(static_cast<int32>(Params.Max.DWColor()));
+			const __m128i AlphaMask = _mm_set1_epi32(static_cast<int32>(FColor(0, 0, 0, 255).DWColor()));
+			const __m128i AllSet = _mm_set1_epi32(-1);
+			for (; Index + 4 <= NumPixels; Index += 4)
+			{
+				const __m128i Pixel = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Index));
+
+				// A channel is in range when clamping it doesn't change it, a pixel when its 4 channels are
+				const __m128i InRange = _mm_cmpeq_epi8(_mm_min_epu8(_mm_max_epu8(Pixel, Min), Max), Pixel);
+				const __m128i Keyed = _mm_cmpeq_epi32(InRange, AllSet);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dest + Index), _mm_andnot_si128(_mm_and_si128(Keyed, AlphaMask), Pixel));
+			}
+#endif
+
+			for (; Index < NumPixels; ++Index)
+			{
+				Dest[Index] = Src[Index];
+				if (IsKeyed(Src[Index], Params))
+				{
+					Dest[Index].A = 0;
+				}
+			}
+		}
+	}
+
+	template<EThumbnailBackgroundMode Mode>
+	void KeyBackground(const FColor* Src, FColor* Dest, int32 NumPixels, const FThumbnailKeyingParams& Params)
+	{
+		if (NumPixels == 0 || (Src == Dest && (Mode != EThumbnailBackgroundMode::Transparent || !Params.bCanMatch)))
+		{
+			return;
+		}
+
+		const int32 NumTasks = FMath::DivideAndRoundUp(NumPixels, KeyingPixelsPerTask);
+		ParallelFor(NumTasks, [Src, Dest, NumPixels, &Params](int32 TaskIndex)
+		{
+			const int32 Start = TaskIndex * KeyingPixelsPerTask;
+			KeyPixels<Mode>(Src + Start, Dest + Start, FMath::Min(KeyingPixelsPerTask, NumPixels - Start), Params);
+		}, NumTasks == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+	}
+
+	/**
+	 * Box filter of DownsampleBox() and KeyAndDownsample(). In Transparent mode the background samples are keyed on the fly and colors
+	 * are weighted by alpha, the other modes average the 4 channels plainly as their alpha isn't coverage and may be 0 everywhere.
+	 */
+	template<EThumbnailBackgroundMode Mode>
+	void KeyAndDownsample(const FColor* SrcPixels, FIntPoint SrcSize, int32 Factor, const FThumbnailKeyingParams& Params, FColor* DestPixels)
+	{
+		const FIntPoint DestSize = SrcSize / Factor;
+
+		// One FColor is processed per vector register, in its BGRA memory order
+		ParallelFor(DestSize.Y, [SrcPixels, DestPixels, SrcSize, DestSize, Factor, &Params](int32 DestY)
+		{
+			const VectorRegister4Float InvNumSamples = VectorSetFloat1(1.f / static_cast<float>(Factor * Factor));
+			const VectorRegister4Float RoundingOffset = VectorSetFloat1(0.5f);
+
+			FColor* DestRow = DestPixels + static_cast<int64>(DestY) * DestSize.X;
+			for (int32 DestX = 0; DestX < DestSize.X; ++DestX)
+			{
+				VectorRegister4Float Result;
+				if constexpr (Mode == EThumbnailBackgroundMode::Transparent)
+				{
+					VectorRegister4Float PremultipliedSum = VectorZeroFloat();
+					VectorRegister4Float AlphaSum = VectorZeroFloat();
+
+					for (int32 SampleY = 0; SampleY < Factor; ++SampleY)
+					{
+						const FColor* SrcRow = SrcPixels + static_cast<int64>(DestY * Factor + SampleY) * SrcSize.X + DestX * Factor;
+						for (int32 SampleX = 0; SampleX < Factor; ++SampleX)
+						{
+							// A keyed sample has no alpha, so it adds nothing to either sum
+							if (Params.bCanMatch && IsKeyed(SrcRow[SampleX], Params))
+							{
+								continue;
+							}
+
+							const VectorRegister4Float Pixel = VectorLoadByte4(&SrcRow[SampleX]);
+							const VectorRegister4Float Alpha = VectorReplicate(Pixel, 3);
+							PremultipliedSum = VectorMultiplyAdd(Pixel, Alpha, PremultipliedSum);
+							AlphaSum = VectorAdd(AlphaSum, Alpha);
+						}
+					}
+
+					// Alphas are whole numbers, so the sum is either 0, where the color sum is 0 too, or at least 1
+					const VectorRegister4Float Color = VectorDivide(PremultipliedSum, VectorMax(AlphaSum, VectorOneFloat()));
+					const VectorRegister4Float CoveredAlpha = VectorMultiply(AlphaSum, InvNumSamples);
+					Result = VectorSelect(GlobalVectorConstants::XYZMask(), Color, CoveredAlpha);
+				}
+				else
+				{
+					VectorRegister4Float Sum = VectorZeroFloat();
+					for (int32 SampleY = 0; SampleY < Factor; ++SampleY)
+					{
+						const FColor* SrcRow = SrcPixels + static_cast<int64>(DestY * Factor + SampleY) * SrcSize.X + DestX * Factor;
+						for (int32 SampleX = 0; SampleX < Factor; ++SampleX)
+						{
+							Sum = VectorAdd(Sum, VectorLoadByte4(&SrcRow[SampleX]));
+						}
+					}
+					Result = VectorMultiply(Sum, InvNumSamples);
+				}
+
+				// VectorStoreByte4 truncates
+				VectorStoreByte4(VectorAdd(Result, RoundingOffset), &DestRow[DestX]);
+			}
+		});
+	}
+
+	/** Plain average of two pixels, rounded like the box filter */
+	FORCEINLINE FColor AveragePairUnweighted(const FColor& First, const FColor& Second)
+	{
+		return FColor((First.R + Second.R + 1) / 2, (First.G + Second.G + 1) / 2, (First.B + Second.B + 1) / 2, (First.A + Second.A + 1) / 2);
+	}
+
+	/** Alpha weighted average of two pixels, rounded like the box filter */
+	FORCEINLINE FColor AveragePair(const FColor& First, const FColor& Second)
+	{
+		const int32 AlphaSum = First.A + Second.A;
+		if (AlphaSum == 0)
+		{
+			return FColor(0, 0, 0, 0);
+		}
+
+		auto AverageChannel = [&First, &Second, AlphaSum](uint8 FirstValue, uint8 SecondValue)
+		{
+			return static_cast<uint8>(static_cast<float>(FirstValue * First.A + SecondValue * Second.A) / AlphaSum + 0.5f);
+		};
+		return FColor(AverageChannel(First.R, Second.R), AverageChannel(First.G, Second.G), AverageChannel(First.B, Second.B), static_cast<uint8>(AlphaSum * 0.5f + 0.5f));
+	}
+}
+
+FThumbnailKeyingParams FThumbnailKeyingParams::Make(const FLinearColor& KeyColor, float Threshold)
+{
+	FThumbnailKeyingParams Params;
+	Params.bCanMatch = true;
+
+	// Channels are tested one at a time, the others being equal to the key color
+	auto MakeRange = [&KeyColor, Threshold](float FLinearColor::* Channel, uint8& OutMin, uint8& OutMax)
+	{
+		bool bFound = false;
+		for (int32 Value = 0; Value < 256; ++Value)
+		{
+			FLinearColor Probe = KeyColor;
+			Probe.*Channel = FColor(Value, Value, Value, Value).ReinterpretAsLinear().R;
+			if (Probe.Equals(KeyColor, Threshold))
+			{
+				OutMin = bFound ? OutMin : static_cast<uint8>(Value);
+				OutMax = static_cast<uint8>(Value);
+				bFound = true;
+			}
+		}
+		return bFound;
+	};
+
+	Params.bCanMatch &= MakeRange(&FLinearColor::R, Params.Min.R, Params.Max.R);
+	Params.bCanMatch &= MakeRange(&FLinearColor::G, Params.Min.G, Params.Max.G);
+	Params.bCanMatch &= MakeRange(&FLinearColor::B, Params.Min.B, Params.Max.B);
+	Params.bCanMatch &= MakeRange(&FLinearColor::A, Params.Min.A, Params.Max.A);
+	return Params;
+}
+
+void ThumbnailImageUtils::DownsampleBox(TArrayView<const FColor> Src, FIntPoint SrcSize, int32 Factor, TArray<FColor>& OutDest)
+{
+	check(Factor >= 1);
+	OutDest.SetNumUninitialized((SrcSize.X / Factor) * (SrcSize.Y / Factor));
+	KeyAndDownsample(EThumbnailBackgroundMode::Opaque, FThumbnailKeyingParams(), Src, SrcSize, Factor, OutDest.GetData());
+}
+
+void ThumbnailImageUtils::KeyAndDownsample(EThumbnailBackgroundMode Mode, const FThumbnailKeyingParams& Params, TArrayView<const FColor> Src, FIntPoint SrcSize, int32 Factor, FColor* Dest)
+{
+	check(Factor >= 1);
+	check(SrcSize.X % Factor == 0 && SrcSize.Y % Factor == 0);
+	check(Src.Num() == SrcSize.X * SrcSize.Y);
+	check(Dest);
+
+	if (Factor == 1)
+	{
+		KeyBackground(Mode, Src, Dest, Params);
+		return;
+	}
+
+	switch (Mode)
+	{
+	case EThumbnailBackgroundMode::Transparent:
+		KeyAndDownsample<EThumbnailBackgroundMode::Transparent>(Src.GetData(), SrcSize, Factor, Params, Dest);
+		break;
+	case EThumbnailBackgroundMode::CustomMaterial:
+		KeyAndDownsample<EThumbnailBackgroundMode::CustomMaterial>(Src.GetData(), SrcSize, Factor, Params, Dest);
+		break;
+	default:
+		KeyAndDownsample<EThumbnailBackgroundMode::Opaque>(Src.GetData(), SrcSize, Factor, Params, Dest);
+		break;
+	}
+}
+
+int32 ThumbnailImageUtils::GetNumMips(FIntPoint Size)
+{
+	if (Size.X <= 0 || Size.Y <= 0 || !FMath::IsPowerOfTwo(Size.X) || !FMath::IsPowerOfTwo(Size.Y))
+	{
+		return 1;
+	}
+	return static_cast<int32>(FMath::FloorLog2(static_cast<uint32>(FMath::Max(Size.X, Size.Y)))) + 1;
+}
+
+int64 ThumbnailImageUtils::GetMipChainNumPixels(FIntPoint Size, int32 NumMips)
+{
+	int64 NumPixels = 0;
+	for (int32 MipIndex = 0; MipIndex < NumMips; ++MipIndex)
+	{
+		NumPixels += static_cast<int64>(Size.X) * Size.Y;
+		Size = FIntPoint(FMath::Max(Size.X / 2, 1), FMath::Max(Size.Y / 2, 1));
+	}
+	return NumPixels;
+}
+
+void ThumbnailImageUtils::BuildMipChain(TArrayView<FColor> Chain, FIntPoint Size, int32 NumMips, bool bAlphaWeighted)
+{
+	check(NumMips >= 1 && NumMips <= GetNumMips(Size));
+	check(Chain.Num() == GetMipChainNumPixels(Size, NumMips));
+
+	FColor* SrcPixels = Chain.GetData();
+	FIntPoint SrcSize = Size;
+	for (int32 MipIndex = 1; MipIndex < NumMips; ++MipIndex)
+	{
+		FColor* DestPixels = SrcPixels + static_cast<int64>(SrcSize.X) * SrcSize.Y;
+		const FIntPoint DestSize(FMath::Max(SrcSize.X / 2, 1), FMath::Max(SrcSize.Y / 2, 1));
+
+		if (SrcSize.X >= 2 && SrcSize.Y >= 2)
+		{
+			// Default keying params match no pixel, the Transparent filter then only weights by alpha
+			if (bAlphaWeighted)
+			{
+				KeyAndDownsample<EThumbnailBackgroundMode::Transparent>(SrcPixels, SrcSize, 2, FThumbnailKeyingParams(), DestPixels);
+			}
+			else
+			{
+				KeyAndDownsample<EThumbnailBackgroundMode::Opaque>(SrcPixels, SrcSize, 2, FThumbnailKeyingParams(), DestPixels);
+			}
+		}
+		else
+		{
+			// The tail of a non square chain is a single row or column, its pixels are paired in memory order either way
+			const int32 NumDestPixels = DestSize.X * DestSize.Y;
+			for (int32 Index = 0; Index < NumDestPixels; ++Index)
+			{
+				DestPixels[Index] = bAlphaWeighted ? AveragePair(SrcPixels[2 * Index], SrcPixels[2 * Index + 1]) : AveragePairUnweighted(SrcPixels[2 * Index], SrcPixels[2 * Index + 1]);
+			}
+		}
+
+		SrcPixels = DestPixels;
+		SrcSize = DestSize;
+	}
+}
+
+void ThumbnailImageUtils::KeyBackground(EThumbnailBackgroundMode Mode, TArrayView<FColor> Pixels, const FThumbnailKeyingParams& Params)
+{
+	KeyBackground(Mode, Pixels, Pixels.GetData(), Params);
+}
+
+void ThumbnailImageUtils::KeyBackground(EThumbnailBackgroundMode Mode, TArrayView<const FColor> Src, FColor* Dest, const FThumbnailKeyingParams& Params)
+{
+	switch (Mode)
+	{
+	case EThumbnailBackgroundMode::Transparent:
+		KeyBackground<EThumbnailBackgroundMode::Transparent>(Src.GetData(), Dest, Src.Num(), Params);
+		break;
+	case EThumbnailBackgroundMode::CustomMaterial:
+		KeyBackground<EThumbnailBackgroundMode::CustomMaterial>(Src.GetData(), Dest, Src.Num(), Params);
+		break;
+	default:
+		KeyBackground<EThumbnailBackgroundMode::Opaque>(Src.GetData(), Dest, Src.Num(), Params);
+		break;
+	}
+}
+void ThumbnailImageUtils::KeyBackgroundReference(TArrayView<FColor> Pixels, const FLinearColor& KeyColor, float Threshold)
+{
+	for (FColor& OldColor : Pixels)
+	{
+		FLinearColor OldLinearColor = OldColor.ReinterpretAsLinear();
+		if (OldLinearColor.Equals(KeyColor, Threshold))
+		{
+			OldColor.A = 0;
+		}
+	}
+}
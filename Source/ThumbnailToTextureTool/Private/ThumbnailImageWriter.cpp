@@ -0,0 +1,97 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailImageWriter.h"
+
+#include "IImageWrapperModule.h"
+#include "ImageCore.h"
+#include "ThumbnailToTextureExporter.h"
+#include "ThumbnailToTextureStats.h"
+#include "Misc/FileHelper.h"
+#include "Modules/ModuleManager.h"
+
+namespace ThumbnailImageWriter
+{
+	/** Set by LoadImageWrappers(), the workers can't load modules */
+	IImageWrapperModule* ImageWrapperModule = nullptr;
+
+	EImageFormat ToImageFormat(EThumbnailOutputFormat Format)
+	{
+		switch (Format)
+		{
+		case EThumbnailOutputFormat::PNG:
+			return EImageFormat::PNG;
+		case EThumbnailOutputFormat::JPEG:
+			return EImageFormat::JPEG;
+		case EThumbnailOutputFormat::EXR:
+			return EImageFormat::EXR;
+		default:
+			return EImageFormat::Invalid;
+		}
+	}
+}
+
+const TCHAR* ThumbnailImageWriter::GetExtension(EThumbnailOutputFormat Format)
+{
+	switch (Format)
+	{
+	case EThumbnailOutputFormat::PNG:
+		return TEXT(".png");
+	case EThumbnailOutputFormat::JPEG:
+		return TEXT(".jpg");
+	case EThumbnailOutputFormat::EXR:
+		return TEXT(".exr");
+	default:
+		return TEXT("");
+	}
+}
+
+void ThumbnailImageWriter::LoadImageWrappers()
+{
+	check(IsInGameThread());
+	if (!ImageWrapperModule)
+	{
+		ImageWrapperModule = &FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+	}
+}
+
+bool ThumbnailImageWriter::Encode(EThumbnailOutputFormat Format, FIntPoint Size, TArray<FColor>& Pixels, TArray64<uint8>& OutData)
+{
+	checkf(ImageWrapperModule, TEXT("LoadImageWrappers() must be called first"));
+	check(Pixels.Num() == Size.X * Size.Y);
+
+	const EImageFormat ImageFormat = ToImageFormat(Format);
+	if (ImageFormat == EImageFormat::Invalid)
+	{
+		return false;
+	}
+
+	// The pixels are display colors like the texture source, the EXR wrapper converts them to linear floats
+	const FImageView Image(Pixels.GetData(), Size.X, Size.Y, EGammaSpace::sRGB);
+	return ImageWrapperModule->CompressImage(OutData, ImageFormat, Image);
+}
+
+UE::Tasks::TTask<bool> ThumbnailImageWriter::Launch(EThumbnailOutputFormat Format, FIntPoint Size, TArray<FColor>&& Pixels, FString Filename)
+{
+	check(ToImageFormat(Format) != EImageFormat::Invalid);
+	LoadImageWrappers();
+
+	return UE::Tasks::Launch(UE_SOURCE_LOCATION, [Format, Size, Pixels = MoveTemp(Pixels), Filename = MoveTemp(Filename)]() mutable
+	{
+		THUMBNAILTOTEXTURE_SCOPE(ImageWrite);
+
+		TArray64<uint8> Compressed;
+		const bool bEncoded = Encode(Format, Size, Pixels, Compressed);
+
+		// Only the encoded file is kept until the task is released
+		Pixels.Empty();
+
+		if (!bEncoded)
+		{
+			UE_LOG(LogThumbnailToTexture, Warning, TEXT("Failed to encode %s"), *Filename);
+			return false;
+		}
+
+		// The file writer creates the missing directories
+		return FFileHelper::SaveArrayToFile(Compressed, *Filename);
+	});
+}
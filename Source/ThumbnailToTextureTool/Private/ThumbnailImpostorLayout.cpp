@@ -0,0 +1,197 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailImpostorLayout.h"
+
+#include "ThumbnailImpostorUserData.h"
+#include "Engine/Texture2D.h"
+#include "UObject/MetaData.h"
+#include "UObject/Package.h"
+
+namespace ThumbnailImpostorLayout
+{
+	/** Metadata tags of earlier exports, removed when the atlas is exported again */
+	const FName GridSizeTag(TEXT("ThumbnailImpostor.GridSize"));
+	const FName FullSphereTag(TEXT("ThumbnailImpostor.FullSphere"));
+
+	/** Buffer visualization materials listed in BaseEngine.ini */
+	const FName WorldNormalMode(TEXT("WorldNormal"));
+
+	double SignNotZero(double Value)
+	{
+		return Value >= 0.0 ? 1.0 : -1.0;
+	}
+}
+
+FThumbnailImpostorLayout::FThumbnailImpostorLayout(int32 InGridSize, bool bInFullSphere)
+	: GridSize(FMath::Max(0, InGridSize))
+	, bFullSphere(bInFullSphere)
+{
+}
+
+FIntRect FThumbnailImpostorLayout::GetViewRect(const FIntRect& RenderRect, EThumbnailImpostorLayer Layer, int32 CellX, int32 CellY) const
+{
+	check(IsImpostor());
+	check(CellX >= 0 && CellX < GridSize && CellY >= 0 && CellY < GridSize);
+
+	const FIntPoint ViewSize(RenderRect.Width() / GridSize, RenderRect.Height() / (GridSize * NumRenderedLayers));
+	const int32 LayerRow = static_cast<int32>(Layer) * GridSize;
+	const FIntPoint ViewMin = RenderRect.Min + FIntPoint(CellX * ViewSize.X, (LayerRow + CellY) * ViewSize.Y);
+	return FIntRect(ViewMin, ViewMin + ViewSize);
+}
+
+FVector FThumbnailImpostorLayout::GetViewDirection(int32 CellX, int32 CellY) const
+{
+	check(IsImpostor());
+
+	// A single view looks straight down
+	const double Scale = GridSize > 1 ? 1.0 / (GridSize - 1) : 0.0;
+	const FVector2D UV = GridSize > 1 ? FVector2D(CellX * Scale, CellY * Scale) : FVector2D(0.5);
+	return OctahedronToDirection(UV, bFullSphere);
+}
+
+FName FThumbnailImpostorLayout::GetBufferVisualizationMode(EThumbnailImpostorLayer Layer)
+{
+	switch (Layer)
+	{
+	case EThumbnailImpostorLayer::WorldNormal:
+		return ThumbnailImpostorLayout::WorldNormalMode;
+	default:
+		return NAME_None;
+	}
+}
+
+FVector FThumbnailImpostorLayout::OctahedronToDirection(const FVector2D& UV, bool bFullSphere)
+{
+	const FVector2D Position = UV * 2.0 - FVector2D(1.0);
+
+	FVector Direction;
+	if (bFullSphere)
+	{
+		Direction = FVector(Position.X, Position.Y, 1.0 - FMath::Abs(Position.X) - FMath::Abs(Position.Y));
+
+		// The lower half of the octahedron is folded over the corners of the square
+		if (Direction.Z < 0.0)
+		{
+			const double X = Direction.X;
+			Direction.X = (1.0 - FMath::Abs(Direction.Y)) * ThumbnailImpostorLayout::SignNotZero(X);
+			Direction.Y = (1.0 - FMath::Abs(X)) * ThumbnailImpostorLayout::SignNotZero(Direction.Y);
+		}
+	}
+	else
+	{
+		const FVector2D Turned((Position.X + Position.Y) * 0.5, (Position.X - Position.Y) * 0.5);
+		Direction = FVector(Turned.X, Turned.Y, 1.0 - FMath::Abs(Turned.X) - FMath::Abs(Turned.Y));
+	}
+
+	return Direction.GetSafeNormal(UE_SMALL_NUMBER, FVector::UpVector);
+}
+
+FVector2D FThumbnailImpostorLayout::DirectionToOctahedron(const FVector& Direction, bool bFullSphere)
+{
+	FVector Octahedron = Direction;
+	if (!bFullSphere)
+	{
+		// Below the horizon is seen as the horizon
+		Octahedron.Z = FMath::Max(Octahedron.Z, 0.0);
+	}
+
+	const double Sum = FMath::Abs(Octahedron.X) + FMath::Abs(Octahedron.Y) + FMath::Abs(Octahedron.Z);
+	if (Sum <= UE_SMALL_NUMBER)
+	{
+		return FVector2D(0.5);
+	}
+	Octahedron /= Sum;
+
+	FVector2D Position;
+	if (bFullSphere)
+	{
+		Position = FVector2D(Octahedron.X, Octahedron.Y);
+		if (Octahedron.Z < 0.0)
+		{
+			Position = FVector2D(
+				(1.0 - FMath::Abs(Octahedron.Y)) * ThumbnailImpostorLayout::SignNotZero(Octahedron.X),
+				(1.0 - FMath::Abs(Octahedron.X)) * ThumbnailImpostorLayout::SignNotZero(Octahedron.Y));
+		}
+	}
+	else
+	{
+		Position = FVector2D(Octahedron.X + Octahedron.Y, Octahedron.X - Octahedron.Y);
+	}
+
+	return Position * 0.5 + FVector2D(0.5);
+}
+
+void FThumbnailImpostorLayout::BuildAtlas(TArrayView<const FColor> RenderPixels, FIntPoint RenderSize, int32 Factor, EThumbnailBackgroundMode Mode, const FThumbnailKeyingParams& Params, FColor* AtlasPixels) const
+{
+	check(IsImpostor());
+	check(RenderSize.Y % NumRenderedLayers == 0);
+	check(RenderPixels.Num() == RenderSize.X * RenderSize.Y);
+
+	// The layers are stacked, so each is a contiguous image of its own
+	const FIntPoint LayerSize(RenderSize.X, RenderSize.Y / NumRenderedLayers);
+	const int32 NumLayerPixels = LayerSize.X * LayerSize.Y;
+	auto GetLayer = [RenderPixels, NumLayerPixels](EThumbnailImpostorLayer Layer)
+	{
+		return RenderPixels.Slice(static_cast<int32>(Layer) * NumLayerPixels, NumLayerPixels);
+	};
+
+	ThumbnailImageUtils::KeyAndDownsample(Mode, Params, GetLayer(EThumbnailImpostorLayer::Color), LayerSize, Factor, AtlasPixels);
+
+	// The alpha of the data layers isn't coverage, the Opaque filter and DownsampleBox() average them without weighting by it
+	FColor* NormalDepthPixels = AtlasPixels + NumLayerPixels / (Factor * Factor);
+	ThumbnailImageUtils::KeyAndDownsample(EThumbnailBackgroundMode::Opaque, FThumbnailKeyingParams(), GetLayer(EThumbnailImpostorLayer::WorldNormal), LayerSize, Factor, NormalDepthPixels);
+
+	// The depth layer is grey, one channel is enough
+	TArray<FColor> DepthPixels;
+	ThumbnailImageUtils::DownsampleBox(GetLayer(EThumbnailImpostorLayer::SceneDepth), LayerSize, Factor, DepthPixels);
+	for (int32 Index = 0; Index < DepthPixels.Num(); ++Index)
+	{
+		NormalDepthPixels[Index].A = DepthPixels[Index].R;
+	}
+}
+
+void FThumbnailImpostorLayout::WriteToTexture(UTexture2D* Texture) const
+{
+	check(Texture);
+	UMetaData* MetaData = Texture->GetOutermost()->GetMetaData();
+	MetaData->RemoveValue(Texture, ThumbnailImpostorLayout::GridSizeTag);
+	MetaData->RemoveValue(Texture, ThumbnailImpostorLayout::FullSphereTag);
+
+	if (!IsImpostor())
+	{
+		// An earlier export of the texture may have been an impostor
+		Texture->RemoveUserDataOfClass(UThumbnailImpostorUserData::StaticClass());
+		return;
+	}
+
+	UThumbnailImpostorUserData* UserData = Texture->GetAssetUserData<UThumbnailImpostorUserData>();
+	if (!UserData)
+	{
+		UserData = NewObject<UThumbnailImpostorUserData>(Texture, NAME_None, RF_Transactional);
+		Texture->AddAssetUserData(UserData);
+	}
+
+	UserData->GridSize = GridSize;
+	UserData->bFullSphere = bFullSphere;
+}
+
+bool FThumbnailImpostorLayout::ReadFromTexture(const UTexture2D* Texture, FThumbnailImpostorLayout& OutLayout)
+{
+	OutLayout = FThumbnailImpostorLayout();
+
+	const TArray<UAssetUserData*>* UserDataArray = Texture ? Texture->GetAssetUserDataArray() : nullptr;
+	if (!UserDataArray)
+	{
+		return false;
+	}
+
+	for (const UAssetUserData* UserData : *UserDataArray)
+	{
+		if (const UThumbnailImpostorUserData* Impostor = Cast<UThumbnailImpostorUserData>(UserData))
+		{
+			OutLayout = FThumbnailImpostorLayout(Impostor->GridSize, Impostor->bFullSphere);
+			return OutLayout.IsImpostor();
+		}
+	}
+	return false;
+}
@@ -0,0 +1,165 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailInputHasher.h"
+
+#include "ThumbnailToTextureSettings.h"
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Materials/Material.h"
+#include "Misc/PackageName.h"
+#include "Misc/SecureHash.h"
+#include "ThumbnailRendering/SceneThumbnailInfo.h"
+
+namespace ThumbnailInputHasher
+{
+	/** Bump when the way textures are produced changes, every recorded or cached thumbnail becomes stale */
+	constexpr int32 Version = 2;
+
+	template<typename ValueType>
+	void HashValue(FSHA1& Hash, const ValueType& Value)
+	{
+		Hash.Update(reinterpret_cast<const uint8*>(&Value), sizeof(Value));
+	}
+
+	void HashString(FSHA1& Hash, const FString& Value)
+	{
+		Hash.UpdateWithString(*Value, Value.Len());
+	}
+}
+
+bool FThumbnailInputHasher::ComputeInputHash(const FAssetData& AssetData, bool bRendered, const FThumbnailToTextureSettingsSnapshot& Settings, FString& OutInputHash)
+{
+	TArray<TPair<FName, FIoHash>> PackageHashes;
+	if (!GatherPackageHashes(AssetData.PackageName, PackageHashes))
+	{
+		return false;
+	}
+
+	// The background material is drawn behind every rendered thumbnail, and the key color of the translucent one is read from
+	// its Color parameter, so an edit of its graph, parameters or textures changes the thumbnails as much as an edit of the asset
+	TArray<TPair<FName, FIoHash>> BackgroundPackageHashes;
+	if (bRendered && Settings.BackgroundMaterial.IsValid() && !GatherPackageHashes(Settings.BackgroundMaterial->GetPackage()->GetFName(), BackgroundPackageHashes))
+	{
+		return false;
+	}
+
+	FSHA1 Hash;
+	ThumbnailInputHasher::HashValue(Hash, ThumbnailInputHasher::Version);
+	ThumbnailInputHasher::HashValue(Hash, bRendered);
+
+	// Both the rendered and the cached textures get the mips
+	ThumbnailInputHasher::HashValue(Hash, Settings.bGenerateMipsOnCPU);
+
+	// Cached thumbnails are copied as they are, only the package matters
+	if (bRendered)
+	{
+		ThumbnailInputHasher::HashValue(Hash, Settings.bUseTransparentBackground);
+		ThumbnailInputHasher::HashValue(Hash, Settings.bUseCustomBackgroundMaterial);
+		ThumbnailInputHasher::HashString(Hash, Settings.BackgroundMaterialPath);
+		ThumbnailInputHasher::HashValue(Hash, Settings.BackgroundCutoffThreshold);
+		ThumbnailInputHasher::HashValue(Hash, Settings.BackgroundMode);
+		ThumbnailInputHasher::HashValue(Hash, Settings.KeyingParams.Min);
+		ThumbnailInputHasher::HashValue(Hash, Settings.KeyingParams.Max);
+		ThumbnailInputHasher::HashValue(Hash, Settings.KeyingParams.bCanMatch);
+		ThumbnailInputHasher::HashValue(Hash, Settings.ThumbnailResolution);
+		ThumbnailInputHasher::HashValue(Hash, Settings.SupersampleFactor);
+		ThumbnailInputHasher::HashValue(Hash, Settings.NumTurntableFrames);
+		ThumbnailInputHasher::HashValue(Hash, Settings.ImpostorGridSize);
+		ThumbnailInputHasher::HashValue(Hash, Settings.bImpostorFullSphere);
+
+		// Used by the assets that have no thumbnail info of their own
+		const USceneThumbnailInfo* DefaultThumbnailInfo = GetDefault<USceneThumbnailInfo>();
+		ThumbnailInputHasher::HashValue(Hash, DefaultThumbnailInfo->OrbitPitch);
+		ThumbnailInputHasher::HashValue(Hash, DefaultThumbnailInfo->OrbitYaw);
+		ThumbnailInputHasher::HashValue(Hash, DefaultThumbnailInfo->OrbitZoom);
+
+		for (const TPair<FName, FIoHash>& PackageHash : BackgroundPackageHashes)
+		{
+			ThumbnailInputHasher::HashString(Hash, PackageHash.Key.ToString());
+			ThumbnailInputHasher::HashValue(Hash, PackageHash.Value);
+		}
+	}
+
+	for (const TPair<FName, FIoHash>& PackageHash : PackageHashes)
+	{
+		ThumbnailInputHasher::HashString(Hash, PackageHash.Key.ToString());
+		ThumbnailInputHasher::HashValue(Hash, PackageHash.Value);
+	}
+
+	Hash.Final();
+	FSHAHash Digest;
+	Hash.GetHash(Digest.Hash);
+	OutInputHash = Digest.ToString();
+	return true;
+}
+
+bool FThumbnailInputHasher::GatherPackageHashes(FName PackageName, TArray<TPair<FName, FIoHash>>& OutPackageHashes)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	TSet<FName> Visited;
+	TArray<FName> ToVisit;
+	ToVisit.Add(PackageName);
+	Visited.Add(PackageName);
+
+	while (ToVisit.Num() > 0)
+	{
+		const FName Current = ToVisit.Pop(false);
+
+		// The saved hash doesn't describe what is in memory
+		const UPackage* LoadedPackage = FindObjectFast<UPackage>(nullptr, Current);
+		if (LoadedPackage && LoadedPackage->IsDirty())
+		{
+			return false;
+		}
+
+		OutPackageHashes.Emplace(Current, GetPackageSavedHash(Current));
+
+		TArray<FName>* Dependencies = PackageDependencies.Find(Current);
+		if (!Dependencies)
+		{
+			Dependencies = &PackageDependencies.Add(Current);
+			AssetRegistry.GetDependencies(Current, *Dependencies, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+		}
+
+		for (const FName Dependency : *Dependencies)
+		{
+			// Script packages change with the binaries, not with the content
+			if (!FPackageName::IsScriptPackage(Dependency.ToString()))
+			{
+				bool bAlreadyVisited = false;
+				Visited.Add(Dependency, &bAlreadyVisited);
+				if (!bAlreadyVisited)
+				{
+					ToVisit.Add(Dependency);
+				}
+			}
+		}
+	}
+
+	// The hash mustn't depend on the traversal order
+	OutPackageHashes.Sort([](const TPair<FName, FIoHash>& A, const TPair<FName, FIoHash>& B)
+	{
+		return A.Key.LexicalLess(B.Key);
+	});
+	return true;
+}
+
+FIoHash FThumbnailInputHasher::GetPackageSavedHash(FName PackageName)
+{
+	if (const FIoHash* SavedHash = PackageSavedHashes.Find(PackageName))
+	{
+		return *SavedHash;
+	}
+
+	FIoHash SavedHash;
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	if (const TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(PackageName))
+	{
+		SavedHash = PackageData->GetPackageSavedHash();
+	}
+
+	PackageSavedHashes.Add(PackageName, SavedHash);
+	return SavedHash;
+}
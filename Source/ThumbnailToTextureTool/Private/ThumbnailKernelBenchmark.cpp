@@ -0,0 +1,205 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailKernelBenchmark.h"
+
+#include "ThumbnailImageUtils.h"
+#include "ThumbnailToTextureExporter.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+namespace ThumbnailKernelBenchmark
+{
+	/** Mid grey background, like the translucent background material */
+	const FLinearColor KeyColor(0.5f, 0.5f, 0.5f, 1.f);
+	constexpr float KeyThreshold = 0.05f;
+
+	/** About half background pixels, with noise around the key color, and half random object pixels */
+	void MakePixels(int32 NumPixels, TArray<FColor>& OutPixels)
+	{
+		FRandomStream Random(0x7E57);
+		const FColor KeyColor8 = KeyColor.ToFColor(false);
+
+		OutPixels.SetNumUninitialized(NumPixels);
+		for (FColor& Pixel : OutPixels)
+		{
+			if (Random.FRand() < 0.5f)
+			{
+				const int32 Noise = Random.RandRange(-20, 20);
+				Pixel = FColor(
+					static_cast<uint8>(FMath::Clamp(KeyColor8.R + Noise, 0, 255)),
+					static_cast<uint8>(FMath::Clamp(KeyColor8.G + Noise, 0, 255)),
+					static_cast<uint8>(FMath::Clamp(KeyColor8.B + Noise, 0, 255)),
+					255);
+			}
+			else
+			{
+				Pixel = FColor(static_cast<uint8>(Random.RandRange(0, 255)), static_cast<uint8>(Random.RandRange(0, 255)), static_cast<uint8>(Random.RandRange(0, 255)), 255);
+			}
+		}
+	}
+
+	/** Per pixel Factor x Factor plain box filter, what the modes that key nothing must produce whatever the alpha of the pixels */
+	void DownsampleReference(const TArray<FColor>& Src, FIntPoint SrcSize, int32 Factor, TArray<FColor>& OutDest)
+	{
+		const FIntPoint DestSize = SrcSize / Factor;
+		const float InvNumSamples = 1.f / static_cast<float>(Factor * Factor);
+		OutDest.SetNumUninitialized(DestSize.X * DestSize.Y);
+		for (int32 DestY = 0; DestY < DestSize.Y; ++DestY)
+		{
+			for (int32 DestX = 0; DestX < DestSize.X; ++DestX)
+			{
+				int32 Sum[4] = {};
+				for (int32 SampleY = 0; SampleY < Factor; ++SampleY)
+				{
+					for (int32 SampleX = 0; SampleX < Factor; ++SampleX)
+					{
+						const FColor& Pixel = Src[(DestY * Factor + SampleY) * SrcSize.X + DestX * Factor + SampleX];
+						Sum[0] += Pixel.R;
+						Sum[1] += Pixel.G;
+						Sum[2] += Pixel.B;
+						Sum[3] += Pixel.A;
+					}
+				}
+
+				auto Average = [InvNumSamples](int32 ChannelSum) { return static_cast<uint8>(ChannelSum * InvNumSamples + 0.5f); };
+				OutDest[DestY * DestSize.X + DestX] = FColor(Average(Sum[0]), Average(Sum[1]), Average(Sum[2]), Average(Sum[3]));
+			}
+		}
+	}
+
+	/** @return pixels per second of Kernel, run NumIterations times on a fresh copy of Pixels */
+	template<typename KernelType>
+	double Measure(const TArray<FColor>& Pixels, int32 NumIterations, TArray<FColor>& OutResult, KernelType&& Kernel)
+	{
+		double TotalSeconds = 0.0;
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			// The copy isn't measured
+			OutResult = Pixels;
+			const double StartTime = FPlatformTime::Seconds();
+			Kernel(OutResult);
+			TotalSeconds += FPlatformTime::Seconds() - StartTime;
+		}
+		return TotalSeconds > 0.0 ? static_cast<double>(Pixels.Num()) * NumIterations / TotalSeconds : 0.0;
+	}
+
+	FAutoConsoleCommand BenchmarkKernelsCommand(
+		TEXT("ThumbnailToTexture.BenchmarkKernels"),
+		TEXT("Measures the CPU pixel kernels of the thumbnail export. Arguments: [NumPixels=1048576] [NumIterations=20]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const int32 NumPixels = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1024 * 1024;
+			const int32 NumIterations = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 20;
+			LogResults(Run(FMath::Max(1, NumPixels), FMath::Max(1, NumIterations)));
+		}));
+}
+
+TArray<FThumbnailKernelBenchmarkResult> ThumbnailKernelBenchmark::Run(int32 NumPixels, int32 NumIterations)
+{
+	TArray<FThumbnailKernelBenchmarkResult> Results;
+
+	TArray<FColor> Pixels;
+	MakePixels(NumPixels, Pixels);
+
+	// Keying
+	{
+		const FThumbnailKeyingParams KeyingParams = FThumbnailKeyingParams::Make(KeyColor, KeyThreshold);
+
+		TArray<FColor> ReferenceKeyed;
+		TArray<FColor> Keyed;
+
+		FThumbnailKernelBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+		Result.Name = TEXT("KeyBackground");
+		Result.ReferencePixelsPerSecond = Measure(Pixels, NumIterations, ReferenceKeyed, [](TArray<FColor>& InOutPixels)
+		{
+			ThumbnailImageUtils::KeyBackgroundReference(InOutPixels, KeyColor, KeyThreshold);
+		});
+		Result.PixelsPerSecond = Measure(Pixels, NumIterations, Keyed, [&KeyingParams](TArray<FColor>& InOutPixels)
+		{
+			ThumbnailImageUtils::KeyBackground(EThumbnailBackgroundMode::Transparent, InOutPixels, KeyingParams);
+		});
+		Result.bMatchesReference = ReferenceKeyed == Keyed;
+	}
+
+	// Downsampling of a 2x supersampled square thumbnail
+	{
+		const int32 Side = FMath::Max(2, static_cast<int32>(FMath::Sqrt(static_cast<float>(NumPixels))) & ~1);
+		TArray<FColor> SquarePixels;
+		MakePixels(Side * Side, SquarePixels);
+
+		TArray<FColor> Downsampled;
+		TArray<FColor> Unused;
+
+		FThumbnailKernelBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+		Result.Name = TEXT("DownsampleBox 2x");
+		Result.PixelsPerSecond = Measure(SquarePixels, NumIterations, Unused, [Side, &Downsampled](TArray<FColor>& InPixels)
+		{
+			ThumbnailImageUtils::DownsampleBox(InPixels, FIntPoint(Side, Side), 2, Downsampled);
+		});
+	}
+
+	// Same over an opaque background, whose render alpha isn't coverage. No alpha at all must not turn the thumbnail black
+	{
+		const int32 Side = FMath::Max(2, static_cast<int32>(FMath::Sqrt(static_cast<float>(NumPixels))) & ~1);
+		TArray<FColor> SquarePixels;
+		MakePixels(Side * Side, SquarePixels);
+		for (FColor& Pixel : SquarePixels)
+		{
+			Pixel.A = 0;
+		}
+
+		TArray<FColor> ReferenceDownsampled;
+		TArray<FColor> Downsampled;
+		TArray<FColor> Unused;
+
+		FThumbnailKernelBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+		Result.Name = TEXT("KeyAndDownsample 2x Opaque, no alpha");
+		Result.ReferencePixelsPerSecond = Measure(SquarePixels, NumIterations, Unused, [Side, &ReferenceDownsampled](TArray<FColor>& InPixels)
+		{
+			DownsampleReference(InPixels, FIntPoint(Side, Side), 2, ReferenceDownsampled);
+		});
+		Result.PixelsPerSecond = Measure(SquarePixels, NumIterations, Unused, [Side, &Downsampled](TArray<FColor>& InPixels)
+		{
+			Downsampled.SetNumUninitialized((Side / 2) * (Side / 2));
+			ThumbnailImageUtils::KeyAndDownsample(EThumbnailBackgroundMode::Opaque, FThumbnailKeyingParams(), InPixels, FIntPoint(Side, Side), 2, Downsampled.GetData());
+		});
+		Result.bMatchesReference = ReferenceDownsampled == Downsampled;
+	}
+
+	// Mips of an exported power of two texture
+	{
+		const int32 Side = static_cast<int32>(FMath::RoundDownToPowerOfTwo(FMath::Max(2u, static_cast<uint32>(FMath::Sqrt(static_cast<float>(NumPixels))))));
+		const int32 NumMips = ThumbnailImageUtils::GetNumMips(FIntPoint(Side, Side));
+		TArray<FColor> Chain;
+		MakePixels(static_cast<int32>(ThumbnailImageUtils::GetMipChainNumPixels(FIntPoint(Side, Side), NumMips)), Chain);
+
+		TArray<FColor> Unused;
+
+		FThumbnailKernelBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+		Result.Name = TEXT("BuildMipChain");
+		Result.PixelsPerSecond = Measure(Chain, NumIterations, Unused, [Side, NumMips](TArray<FColor>& InOutChain)
+		{
+			ThumbnailImageUtils::BuildMipChain(InOutChain, FIntPoint(Side, Side), NumMips, true);
+		});
+	}
+
+	return Results;
+}
+
+void ThumbnailKernelBenchmark::LogResults(const TArray<FThumbnailKernelBenchmarkResult>& Results)
+{
+	for (const FThumbnailKernelBenchmarkResult& Result : Results)
+	{
+		if (Result.ReferencePixelsPerSecond > 0.0)
+		{
+			UE_LOG(LogThumbnailToTexture, Display, TEXT("%s: %.1f Mpixels/s, former implementation %.1f Mpixels/s (x%.1f)%s"),
+				*Result.Name, Result.PixelsPerSecond / 1e6, Result.ReferencePixelsPerSecond / 1e6,
+				Result.PixelsPerSecond / Result.ReferencePixelsPerSecond,
+				Result.bMatchesReference ? TEXT("") : TEXT(", OUTPUT DIFFERS"));
+		}
+		else
+		{
+			UE_LOG(LogThumbnailToTexture, Display, TEXT("%s: %.1f Mpixels/s"), *Result.Name, Result.PixelsPerSecond / 1e6);
+		}
+	}
+}
@@ -0,0 +1,198 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailReadbackRing.h"
+
+#include "IThumbnailToTextureTool.h"
+#include "RenderingThread.h"
+#include "ThumbnailRenderTargetPool.h"
+#include "ThumbnailToTextureStats.h"
+#include "RealtimeGPUProfiler.h"
+#include "RHIGPUReadback.h"
+#include "Async/ParallelFor.h"
+#include "Engine/TextureRenderTarget2D.h"
+
+DECLARE_GPU_STAT_NAMED(ThumbnailToTextureReadback, TEXT("ThumbnailToTexture Readback"));
+
+FThumbnailReadbackRing::FThumbnailReadbackRing(int32 InNumSlots, FIntPoint InSize)
+	: Size(InSize)
+	, OldestSlot(0)
+	, NumInFlight(0)
+	, bRendering(false)
+{
+	check(InNumSlots > 0);
+	Slots.SetNum(InNumSlots);
+
+	for (int32 SlotIndex = 0; SlotIndex < Slots.Num(); ++SlotIndex)
+	{
+		Slots[SlotIndex].Readback = MakeUnique<FRHIGPUTextureReadback>(*FString::Printf(TEXT("ThumbnailReadback%d"), SlotIndex));
+	}
+}
+
+FThumbnailReadbackRing::~FThumbnailReadbackRing()
+{
+	// The render thread may still reference the readbacks
+	FlushRenderingCommands();
+
+	if (!GExitPurge)
+	{
+		FThumbnailRenderTargetPool& RenderTargetPool = IThumbnailToTextureToolModule::GetRenderTargetPool();
+		for (FSlot& Slot : Slots)
+		{
+			RenderTargetPool.Release(Slot.RenderTarget);
+		}
+	}
+	Slots.Empty();
+}
+
+FTextureRenderTargetResource* FThumbnailReadbackRing::BeginRender(TArray<FThumbnailReadback>& OutCompleted)
+{
+	check(!bRendering);
+
+	if (NumInFlight == Slots.Num())
+	{
+		CompleteOldest(OutCompleted, true);
+	}
+
+	bRendering = true;
+	FSlot& Slot = Slots[(OldestSlot + NumInFlight) % Slots.Num()];
+	check(!Slot.RenderTarget);
+	Slot.RenderTarget = IThumbnailToTextureToolModule::GetRenderTargetPool().Acquire(Size, PF_FloatRGBA);
+	return Slot.RenderTarget->GameThread_GetRenderTargetResource();
+}
+
+void FThumbnailReadbackRing::EndRender(int32 RequestId)
+{
+	const FThumbnailReadbackTile Tile{RequestId, FIntRect(FIntPoint::ZeroValue, Size)};
+	EndRender(MakeArrayView(&Tile, 1));
+}
+
+void FThumbnailReadbackRing::EndRender(TArrayView<const FThumbnailReadbackTile> Tiles)
+{
+	check(bRendering);
+	bRendering = false;
+
+	FSlot& Slot = Slots[(OldestSlot + NumInFlight) % Slots.Num()];
+	Slot.Tiles = Tiles;
+	++NumInFlight;
+
+	FTextureRenderTargetResource* RenderTargetResource = Slot.RenderTarget->GameThread_GetRenderTargetResource();
+	FRHIGPUTextureReadback* Readback = Slot.Readback.Get();
+	ENQUEUE_RENDER_COMMAND(ThumbnailReadbackCopy)(
+		[RenderTargetResource, Readback](FRHICommandListImmediate& RHICmdList)
+		{
+			SCOPED_DRAW_EVENT(RHICmdList, ThumbnailToTextureReadback);
+			SCOPED_GPU_STAT(RHICmdList, ThumbnailToTextureReadback);
+
+			FRHITexture* Texture = RenderTargetResource->GetRenderTargetTexture();
+			RHICmdList.Transition(FRHITransitionInfo(Texture, ERHIAccess::Unknown, ERHIAccess::CopySrc));
+			Readback->EnqueueCopy(RHICmdList, Texture);
+		});
+}
+
+void FThumbnailReadbackRing::PollCompleted(TArray<FThumbnailReadback>& OutCompleted)
+{
+	while (NumInFlight > 0 && CompleteOldest(OutCompleted, false))
+	{
+	}
+}
+
+void FThumbnailReadbackRing::Flush(TArray<FThumbnailReadback>& OutCompleted)
+{
+	while (NumInFlight > 0)
+	{
+		CompleteOldest(OutCompleted, true);
+	}
+}
+
+bool FThumbnailReadbackRing::CompleteOldest(TArray<FThumbnailReadback>& OutCompleted, bool bWait)
+{
+	check(NumInFlight > 0);
+	THUMBNAILTOTEXTURE_SCOPE(Readback);
+
+	FSlot& Slot = Slots[OldestSlot];
+	FRHIGPUTextureReadback* Readback = Slot.Readback.Get();
+
+	if (!Readback->IsReady())
+	{
+		if (!bWait)
+		{
+			return false;
+		}
+
+		// Make sure the copy was handed to the GPU, then wait for it
+		FlushRenderingCommands();
+		while (!Readback->IsReady())
+		{
+			FPlatformProcess::SleepNoStats(0.0f);
+		}
+	}
+
+	// Rows of every tile are converted in one go, straight from the mapped staging texture
+	struct FTileRows
+	{
+		FIntRect Rect;
+		FColor* OutPixels;
+	};
+	TArray<FTileRows> TileRows;
+	for (const FThumbnailReadbackTile& Tile : Slot.Tiles)
+	{
+		const FIntRect Rect(Tile.Rect.Min.ComponentMax(FIntPoint::ZeroValue), Tile.Rect.Max.ComponentMin(Size));
+		check(Rect.Area() > 0);
+
+		FThumbnailReadback& Completed = OutCompleted.AddDefaulted_GetRef();
+		Completed.RequestId = Tile.RequestId;
+		Completed.Width = Rect.Width();
+		Completed.Height = Rect.Height();
+		Completed.Pixels.SetNumUninitialized(Rect.Area());
+		TileRows.Add({Rect, Completed.Pixels.GetData()});
+	}
+
+	// Staging textures can only be mapped on the rendering thread
+	ENQUEUE_RENDER_COMMAND(ThumbnailReadbackLock)(
+		[Readback, TileRows = MoveTemp(TileRows)](FRHICommandListImmediate& RHICmdList)
+		{
+			int32 RowPitchInPixels = 0;
+			const FFloat16Color* SrcPixels = static_cast<const FFloat16Color*>(Readback->Lock(RowPitchInPixels));
+			check(SrcPixels);
+
+			int32 NumRows = 0;
+			for (const FTileRows& Tile : TileRows)
+			{
+				NumRows += Tile.Rect.Height();
+			}
+
+			// Same conversion as FRenderTarget::ReadPixels with the default FReadSurfaceDataFlags
+			ParallelFor(NumRows, [SrcPixels, &TileRows, RowPitchInPixels](int32 Row)
+			{
+				int32 TileIndex = 0;
+				while (Row >= TileRows[TileIndex].Rect.Height())
+				{
+					Row -= TileRows[TileIndex].Rect.Height();
+					++TileIndex;
+				}
+
+				const FIntRect& Rect = TileRows[TileIndex].Rect;
+				const FFloat16Color* SrcRow = SrcPixels + static_cast<int64>(Rect.Min.Y + Row) * RowPitchInPixels + Rect.Min.X;
+				FColor* DestRow = TileRows[TileIndex].OutPixels + static_cast<int64>(Row) * Rect.Width();
+				for (int32 X = 0; X < Rect.Width(); ++X)
+				{
+					DestRow[X] = FLinearColor(SrcRow[X]).ToFColor(true);
+				}
+			});
+
+			Readback->Unlock();
+		});
+
+	FRenderCommandFence LockFence;
+	LockFence.BeginFence();
+	LockFence.Wait();
+
+	// Nothing reads from the render target anymore
+	IThumbnailToTextureToolModule::GetRenderTargetPool().Release(Slot.RenderTarget);
+	Slot.RenderTarget = nullptr;
+
+	Slot.Tiles.Reset();
+	OldestSlot = (OldestSlot + 1) % Slots.Num();
+	--NumInFlight;
+	return true;
+}
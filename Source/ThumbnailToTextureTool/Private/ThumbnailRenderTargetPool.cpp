@@ -0,0 +1,119 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailRenderTargetPool.h"
+
+#include "Engine/TextureRenderTarget2D.h"
+
+FThumbnailRenderTargetPool::FThumbnailRenderTargetPool()
+	: MaxPooledRenderTargets(8)
+{
+}
+
+FThumbnailRenderTargetPool::~FThumbnailRenderTargetPool()
+{
+	Empty();
+}
+
+UTextureRenderTarget2D* FThumbnailRenderTargetPool::Acquire(FIntPoint Size, EPixelFormat Format)
+{
+	check(IsInGameThread());
+
+	if (TArray<UTextureRenderTarget2D*>* RenderTargets = PooledRenderTargets.Find({Size, Format}))
+	{
+		if (RenderTargets->Num() > 0)
+		{
+			UTextureRenderTarget2D* RenderTarget = RenderTargets->Pop(false);
+			++Stats.NumHits;
+			--Stats.NumPooled;
+
+			// Only clears, the resource keeps its GPU allocation
+			RenderTarget->UpdateResourceImmediate(true);
+			return RenderTarget;
+		}
+	}
+
+	++Stats.NumMisses;
+
+	UTextureRenderTarget2D* RenderTarget = NewObject<UTextureRenderTarget2D>();
+	check(RenderTarget);
+	RenderTarget->AddToRoot();
+	RenderTarget->ClearColor = FLinearColor::White;
+	RenderTarget->SRGB = 1;
+	RenderTarget->RenderTargetFormat = RTF_RGBA8;
+	constexpr bool bForceLinearGamma = false;
+	RenderTarget->InitCustomFormat(Size.X, Size.Y, Format, bForceLinearGamma);
+	RenderTarget->UpdateResourceImmediate(true);
+	return RenderTarget;
+}
+
+void FThumbnailRenderTargetPool::Release(UTextureRenderTarget2D* RenderTarget)
+{
+	check(IsInGameThread());
+	if (!RenderTarget)
+	{
+		return;
+	}
+
+	if (Stats.NumPooled >= MaxPooledRenderTargets)
+	{
+		++Stats.NumDiscarded;
+		DestroyRenderTarget(RenderTarget);
+		return;
+	}
+
+	const FPoolKey Key{FIntPoint(RenderTarget->SizeX, RenderTarget->SizeY), RenderTarget->GetFormat()};
+	PooledRenderTargets.FindOrAdd(Key).Add(RenderTarget);
+	++Stats.NumPooled;
+}
+
+void FThumbnailRenderTargetPool::Empty()
+{
+	for (TPair<FPoolKey, TArray<UTextureRenderTarget2D*>>& Pair : PooledRenderTargets)
+	{
+		for (UTextureRenderTarget2D* RenderTarget : Pair.Value)
+		{
+			DestroyRenderTarget(RenderTarget);
+		}
+	}
+	PooledRenderTargets.Empty();
+	Stats.NumPooled = 0;
+}
+
+void FThumbnailRenderTargetPool::SetMaxPooledRenderTargets(int32 InMaxPooledRenderTargets)
+{
+	MaxPooledRenderTargets = FMath::Max(0, InMaxPooledRenderTargets);
+
+	// Trim the biggest render targets first when the cap goes down
+	while (Stats.NumPooled > MaxPooledRenderTargets)
+	{
+		TArray<UTextureRenderTarget2D*>* Largest = nullptr;
+		int64 LargestArea = -1;
+		for (TPair<FPoolKey, TArray<UTextureRenderTarget2D*>>& Pair : PooledRenderTargets)
+		{
+			const int64 Area = static_cast<int64>(Pair.Key.Size.X) * Pair.Key.Size.Y;
+			if (Pair.Value.Num() > 0 && Area > LargestArea)
+			{
+				Largest = &Pair.Value;
+				LargestArea = Area;
+			}
+		}
+
+		check(Largest);
+		++Stats.NumDiscarded;
+		--Stats.NumPooled;
+		DestroyRenderTarget(Largest->Pop(false));
+	}
+}
+
+void FThumbnailRenderTargetPool::DestroyRenderTarget(UTextureRenderTarget2D* RenderTarget)
+{
+	// During exit purge the objects may already be gone
+	if (GExitPurge)
+	{
+		return;
+	}
+
+	RenderTarget->ReleaseResource();
+	RenderTarget->RemoveFromRoot();
+	RenderTarget->MarkAsGarbage();
+}
@@ -0,0 +1,132 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailSceneCache.h"
+
+#include "CustomThumbnailHelpers.h"
+#include "RenderingThread.h"
+#include "UObject/UObjectHash.h"
+
+FThumbnailSceneCache::FThumbnailSceneCache()
+	: BudgetBytes(256 * 1024 * 1024)
+	, UseCounter(0)
+{
+}
+
+FThumbnailSceneCache::~FThumbnailSceneCache()
+{
+	Empty();
+}
+
+TSharedRef<FCustomThumbnailPreviewScene> FThumbnailSceneCache::FindOrAdd(const FSceneKey& Key, TFunctionRef<TSharedRef<FCustomThumbnailPreviewScene>()> CreateScene)
+{
+	check(IsInGameThread());
+
+	if (FEntry* Entry = Entries.Find(Key))
+	{
+		++Stats.NumHits;
+		Entry->LastUse = ++UseCounter;
+		return Entry->Scene;
+	}
+
+	++Stats.NumMisses;
+
+	// Make room before creating the scene, it can only be measured once populated
+	Trim(BudgetBytes, MaxScenes - 1);
+
+	FEntry& NewEntry = Entries.Emplace(Key, FEntry{CreateScene()});
+	NewEntry.LastUse = ++UseCounter;
+	Stats.NumScenes = Entries.Num();
+	return NewEntry.Scene;
+}
+
+void FThumbnailSceneCache::Remove(const void* Owner, const UObject* Object)
+{
+	const FSceneKey Key{Owner, FObjectKey(Object)};
+	if (const FEntry* Entry = Entries.Find(Key))
+	{
+		Stats.EstimatedSizeBytes -= FMath::Max<int64>(Entry->EstimatedSizeBytes, 0);
+		Entries.Remove(Key);
+		Stats.NumScenes = Entries.Num();
+	}
+}
+
+void FThumbnailSceneCache::RemoveAll(const void* Owner)
+{
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (It.Key().Owner == Owner)
+		{
+			Stats.EstimatedSizeBytes -= FMath::Max<int64>(It.Value().EstimatedSizeBytes, 0);
+			It.RemoveCurrent();
+		}
+	}
+	Stats.NumScenes = Entries.Num();
+}
+
+void FThumbnailSceneCache::Empty()
+{
+	Entries.Empty();
+	Stats.NumScenes = 0;
+	Stats.EstimatedSizeBytes = 0;
+}
+
+void FThumbnailSceneCache::SetBudgetBytes(int64 InBudgetBytes)
+{
+	BudgetBytes = FMath::Max<int64>(0, InBudgetBytes);
+	Trim(BudgetBytes, MaxScenes);
+}
+
+void FThumbnailSceneCache::Trim(int64 MaxSizeBytes, int32 MaxNumScenes)
+{
+	for (TPair<FSceneKey, FEntry>& Pair : Entries)
+	{
+		if (Pair.Value.EstimatedSizeBytes == INDEX_NONE)
+		{
+			Pair.Value.EstimatedSizeBytes = EstimateSceneSize(Pair.Value.Scene.Get());
+			Stats.EstimatedSizeBytes += Pair.Value.EstimatedSizeBytes;
+		}
+	}
+
+	bool bEvicted = false;
+	while ((Stats.EstimatedSizeBytes > MaxSizeBytes || Entries.Num() > MaxNumScenes) && Entries.Num() > 0)
+	{
+		const FSceneKey* LeastRecentlyUsed = nullptr;
+		uint64 OldestUse = MAX_uint64;
+		for (const TPair<FSceneKey, FEntry>& Pair : Entries)
+		{
+			if (Pair.Value.LastUse < OldestUse)
+			{
+				LeastRecentlyUsed = &Pair.Key;
+				OldestUse = Pair.Value.LastUse;
+			}
+		}
+
+		check(LeastRecentlyUsed);
+		const FSceneKey Key = *LeastRecentlyUsed;
+		Stats.EstimatedSizeBytes -= Entries[Key].EstimatedSizeBytes;
+		Entries.Remove(Key);
+		++Stats.NumEvictions;
+		bEvicted = true;
+	}
+
+	if (bEvicted)
+	{
+		// Same as the engine's thumbnail scene caches, the rendering thread may still reference the freed scenes
+		FlushRenderingCommands();
+	}
+	Stats.NumScenes = Entries.Num();
+}
+
+int64 FThumbnailSceneCache::EstimateSceneSize(const FCustomThumbnailPreviewScene& Scene)
+{
+	int64 SizeBytes = sizeof(Scene);
+	if (const UWorld* World = Scene.GetWorld())
+	{
+		SizeBytes += World->GetClass()->GetStructureSize();
+		ForEachObjectWithOuter(World, [&SizeBytes](UObject* Object)
+		{
+			SizeBytes += Object->GetClass()->GetStructureSize() + Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		});
+	}
+	return SizeBytes;
+}
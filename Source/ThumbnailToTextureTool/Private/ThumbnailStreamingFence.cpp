@@ -0,0 +1,127 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailStreamingFence.h"
+
+#include "ContentStreaming.h"
+#include "ThumbnailToTextureStats.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/SkinnedAsset.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/Texture.h"
+
+namespace ThumbnailStreamingFence
+{
+	/** The assets stay forced resident this long after the wait, until the render reading them was issued */
+	constexpr double ResidencyMarginSeconds = 5.0;
+
+	/** Longest time the streamer is left to process its requests between two checks of the assets */
+	constexpr float PollIntervalSeconds = 0.01f;
+}
+
+void FThumbnailStreamingFence::AddComponents(TArrayView<const UPrimitiveComponent* const> Components)
+{
+	TArray<UTexture*> UsedTextures;
+	for (const UPrimitiveComponent* Component : Components)
+	{
+		if (!Component)
+		{
+			continue;
+		}
+
+		// GetUsedTextures() isn't const but doesn't modify the component, Num uses the current material quality level
+		UsedTextures.Reset();
+		const_cast<UPrimitiveComponent*>(Component)->GetUsedTextures(UsedTextures, EMaterialQualityLevel::Num);
+		for (UTexture* Texture : UsedTextures)
+		{
+			if (Texture)
+			{
+				Assets.AddUnique(Texture);
+			}
+		}
+
+		// Meshes stream their LODs like textures stream their mips
+		if (const UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(Component))
+		{
+			if (UStaticMesh* StaticMesh = StaticMeshComponent->GetStaticMesh())
+			{
+				Assets.AddUnique(StaticMesh);
+			}
+		}
+		else if (const USkinnedMeshComponent* SkinnedMeshComponent = Cast<USkinnedMeshComponent>(Component))
+		{
+			if (USkinnedAsset* SkinnedAsset = SkinnedMeshComponent->GetSkinnedAsset())
+			{
+				Assets.AddUnique(SkinnedAsset);
+			}
+		}
+	}
+}
+
+FThumbnailStreamingWaitResult FThumbnailStreamingFence::Wait(double TimeoutSeconds)
+{
+	check(IsInGameThread());
+
+	FThumbnailStreamingWaitResult Result;
+	Result.NumAssets = Assets.Num();
+	if (Assets.Num() == 0)
+	{
+		return Result;
+	}
+
+	// Only for this render, the streamer drops the assets back to what the views need once the time is up
+	const float ForceResidentSeconds = static_cast<float>(FMath::Max(TimeoutSeconds, 0.0) + ThumbnailStreamingFence::ResidencyMarginSeconds);
+	for (const TWeakObjectPtr<UStreamableRenderAsset>& Asset : Assets)
+	{
+		if (UStreamableRenderAsset* StreamableAsset = Asset.Get())
+		{
+			StreamableAsset->SetForceMipLevelsToBeResident(ForceResidentSeconds);
+		}
+	}
+
+	int32 NumPendingAssets = GetNumPendingAssets();
+	if (NumPendingAssets == 0 || TimeoutSeconds <= 0.0)
+	{
+		Result.NumPendingAssets = NumPendingAssets;
+		return Result;
+	}
+
+	THUMBNAILTOTEXTURE_SCOPE(StreamingWait);
+	THUMBNAILTOTEXTURE_COUNT(StreamingWait, 1);
+
+	IStreamingManager& StreamingManager = IStreamingManager::Get();
+	const double StartTime = FPlatformTime::Seconds();
+	while (NumPendingAssets > 0)
+	{
+		const double RemainingSeconds = TimeoutSeconds - (FPlatformTime::Seconds() - StartTime);
+		if (RemainingSeconds <= 0.0)
+		{
+			Result.bTimedOut = true;
+			break;
+		}
+
+		// Picks up the forced assets and issues their requests right away instead of spreading them over frames
+		StreamingManager.UpdateResourceStreaming(0.f, true);
+		StreamingManager.BlockTillAllRequestsFinished(FMath::Min(static_cast<float>(RemainingSeconds), ThumbnailStreamingFence::PollIntervalSeconds));
+		NumPendingAssets = GetNumPendingAssets();
+	}
+
+	Result.WaitSeconds = FPlatformTime::Seconds() - StartTime;
+	Result.NumPendingAssets = NumPendingAssets;
+	return Result;
+}
+
+int32 FThumbnailStreamingFence::GetNumPendingAssets() const
+{
+	int32 NumPendingAssets = 0;
+	for (const TWeakObjectPtr<UStreamableRenderAsset>& Asset : Assets)
+	{
+		UStreamableRenderAsset* StreamableAsset = Asset.Get();
+		if (StreamableAsset && (StreamableAsset->HasPendingInitOrStreaming() || !StreamableAsset->IsFullyStreamedIn()))
+		{
+			++NumPendingAssets;
+		}
+	}
+	return NumPendingAssets;
+}
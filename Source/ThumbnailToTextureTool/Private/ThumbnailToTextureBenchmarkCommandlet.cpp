@@ -0,0 +1,581 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailToTextureBenchmarkCommandlet.h"
+
+#include "IThumbnailToTextureTool.h"
+#include "MeshDescriptionBuilder.h"
+#include "ObjectTools.h"
+#include "RHI.h"
+#include "StaticMeshAttributes.h"
+#include "ThumbnailContainerWriter.h"
+#include "ThumbnailImpostorLayout.h"
+#include "ThumbnailKernelBenchmark.h"
+#include "ThumbnailToTextureExporter.h"
+#include "ThumbnailToTextureSettings.h"
+#include "ThumbnailToTextureStats.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Components/StaticMeshComponent.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Blueprint.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Engine/SCS_Node.h"
+#include "Engine/SimpleConstructionScript.h"
+#include "Engine/StaticMesh.h"
+#include "Interfaces/IPluginManager.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "Materials/Material.h"
+#include "Math/RandomStream.h"
+#include "Misc/App.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/SavePackage.h"
+
+namespace ThumbnailToTextureBenchmark
+{
+	/** Everything the benchmark creates lives under this folder */
+	const TCHAR* const RootPath = TEXT("/Game/ThumbnailToTextureBenchmark");
+
+	/** Assets exported once before each measured run, so one time costs such as shader compilation and scene creation aren't measured */
+	constexpr int32 NumWarmUpAssets = 4;
+
+	struct FBackgroundMode
+	{
+		const TCHAR* Name;
+		bool bUseCustomBackgroundMaterial;
+		bool bUseTransparentBackground;
+
+		/** Exports impostor atlases of this many views per side instead of thumbnails, overridden by -ImpostorGridSize */
+		int32 ImpostorGridSize;
+	};
+
+	const FBackgroundMode BackgroundModes[] =
+	{
+		{TEXT("Cached"), false, false, 0},
+		{TEXT("CustomMaterial"), true, false, 0},
+		{TEXT("Transparent"), false, true, 0},
+		{TEXT("Impostor"), false, true, 8},
+	};
+
+	/** Width and height of the thumbnails of the container benchmark */
+	constexpr int32 ContainerEntrySize = 32;
+
+	/** Times the container is opened, the average is reported */
+	constexpr int32 NumContainerOpens = 20;
+
+	double ToMegabytes(uint64 Bytes)
+	{
+		return Bytes / (1024.0 * 1024.0);
+	}
+}
+
+UThumbnailToTextureBenchmarkCommandlet::UThumbnailToTextureBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UThumbnailToTextureBenchmarkCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	auto GetIntParam = [&ParamVals](const TCHAR* Name, int32 DefaultValue)
+	{
+		const FString* Value = ParamVals.Find(Name);
+		return Value ? FMath::Max(1, FCString::Atoi(**Value)) : DefaultValue;
+	};
+
+	const FString* OutputParam = ParamVals.Find(TEXT("Output"));
+	const FString OutputFilename = OutputParam ? *OutputParam : FPaths::ProjectSavedDir() / TEXT("ThumbnailToTexture") / TEXT("Benchmark.json");
+
+	bool bSucceeded = true;
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetObjectField(TEXT("Environment"), DescribeEnvironment());
+
+	// CPU kernels, also run on machines without a GPU
+	{
+		const TArray<FThumbnailKernelBenchmarkResult> KernelResults = ThumbnailKernelBenchmark::Run(GetIntParam(TEXT("NumPixels"), 1024 * 1024), GetIntParam(TEXT("Iterations"), 20));
+		ThumbnailKernelBenchmark::LogResults(KernelResults);
+
+		TArray<TSharedPtr<FJsonValue>> KernelValues;
+		for (const FThumbnailKernelBenchmarkResult& Result : KernelResults)
+		{
+			TSharedRef<FJsonObject> KernelObject = MakeShared<FJsonObject>();
+			KernelObject->SetStringField(TEXT("Name"), Result.Name);
+			KernelObject->SetNumberField(TEXT("PixelsPerSecond"), Result.PixelsPerSecond);
+			KernelObject->SetNumberField(TEXT("ReferencePixelsPerSecond"), Result.ReferencePixelsPerSecond);
+			KernelObject->SetBoolField(TEXT("MatchesReference"), Result.bMatchesReference);
+			KernelValues.Add(MakeShared<FJsonValueObject>(KernelObject));
+			bSucceeded &= Result.bMatchesReference;
+		}
+		Root->SetArrayField(TEXT("Kernels"), KernelValues);
+	}
+
+	// Container lookups, also CPU only
+	{
+		bool bValid = true;
+		Root->SetObjectField(TEXT("Container"), BenchmarkContainer(GetIntParam(TEXT("ContainerEntries"), 20000), GetIntParam(TEXT("ContainerLookups"), 1000000), Switches.Contains(TEXT("KeepContent")), bValid));
+		bSucceeded &= bValid;
+	}
+
+	if (!Switches.Contains(TEXT("KernelsOnly")))
+	{
+		if (!FApp::CanEverRender())
+		{
+			UE_LOG(LogThumbnailToTexture, Error, TEXT("The export benchmark needs rendering, pass -AllowCommandletRendering or use -KernelsOnly"));
+			return 1;
+		}
+
+		UThumbnailToTextureSettings& Settings = IThumbnailToTextureToolModule::GetEditorSettings();
+		Settings.LoadTranslucentMaterial();
+
+		// Left over by a previous run with -KeepContent
+		DeleteContent();
+
+		// A folder of real props measures what the synthetic content can't, like their materials and texture streaming
+		TArray<FAssetData> Assets;
+		if (const FString* ContentPathParam = ParamVals.Find(TEXT("ContentPath")))
+		{
+			if (!GatherContent(*ContentPathParam, Assets))
+			{
+				UE_LOG(LogThumbnailToTexture, Error, TEXT("No static mesh or blueprint found under %s"), **ContentPathParam);
+				return 1;
+			}
+		}
+		else if (!CreateContent(GetIntParam(TEXT("NumStaticMeshes"), 64), GetIntParam(TEXT("NumBlueprints"), 32), GetIntParam(TEXT("MaxComponents"), 8), Assets))
+		{
+			UE_LOG(LogThumbnailToTexture, Error, TEXT("Couldn't create the benchmark content"));
+			DeleteContent();
+			return 1;
+		}
+
+		TArray<FString> ModeNames;
+		if (const FString* ModesParam = ParamVals.Find(TEXT("Modes")))
+		{
+			ModesParam->ParseIntoArray(ModeNames, TEXT("+"));
+		}
+
+		// Only changed in memory, the config file isn't touched
+		const bool bSavedUseCustomBackgroundMaterial = Settings.UseCustomBackgroundMaterial;
+		const bool bSavedUseTransparentBackground = Settings.UseTransparentBackground;
+		const FSoftObjectPath SavedBackgroundMaterial = Settings.BackgroundMaterial;
+		const FDirectoryPath SavedRootTexture2DSaveDir = Settings.RootTexture2DSaveDir;
+		const int32 SavedImpostorGridSize = Settings.ImpostorGridSize;
+		const EThumbnailOutputFormat SavedOutputFormat = Settings.OutputFormat;
+		const FDirectoryPath SavedImageOutputDirectory = Settings.ImageOutputDirectory;
+		const FFilePath SavedContainerFile = Settings.ContainerFile;
+
+		// Every mode writes image files or a container instead of texture packages
+		if (const FString* OutputFormatParam = ParamVals.Find(TEXT("OutputFormat")))
+		{
+			const int64 OutputFormat = StaticEnum<EThumbnailOutputFormat>()->GetValueByNameString(*OutputFormatParam);
+			if (OutputFormat == INDEX_NONE)
+			{
+				UE_LOG(LogThumbnailToTexture, Error, TEXT("Unknown output format %s, use Texture2D, PNG, JPEG, EXR or Container"), **OutputFormatParam);
+				DeleteContent();
+				return 1;
+			}
+			Settings.OutputFormat = static_cast<EThumbnailOutputFormat>(OutputFormat);
+		}
+
+		if (Settings.BackgroundMaterial.IsNull())
+		{
+			Settings.BackgroundMaterial = FSoftObjectPath(TEXT("/ThumbnailToTextureTool/BackgroundMaterialNoShadow.BackgroundMaterialNoShadow"));
+		}
+
+		TArray<TSharedPtr<FJsonValue>> ModeValues;
+		for (const ThumbnailToTextureBenchmark::FBackgroundMode& Mode : ThumbnailToTextureBenchmark::BackgroundModes)
+		{
+			if (ModeNames.Num() > 0 && !ModeNames.Contains(Mode.Name))
+			{
+				continue;
+			}
+
+			Settings.UseCustomBackgroundMaterial = Mode.bUseCustomBackgroundMaterial;
+			Settings.UseTransparentBackground = Mode.bUseTransparentBackground;
+			Settings.ImpostorGridSize = Mode.ImpostorGridSize > 0 ? GetIntParam(TEXT("ImpostorGridSize"), Mode.ImpostorGridSize) : 0;
+			Settings.RootTexture2DSaveDir.Path = FString::Printf(TEXT("%s/Textures/%s/"), ThumbnailToTextureBenchmark::RootPath, Mode.Name);
+			// Next to the textures, so DeleteContent() removes them too. Full, a relative path would be taken from the project directory
+			Settings.ImageOutputDirectory.Path = FPaths::ConvertRelativePathToFull(FPaths::Combine(FPackageName::LongPackageNameToFilename(ThumbnailToTextureBenchmark::RootPath), TEXT("Images"), Mode.Name));
+			Settings.ContainerFile.FilePath = FPaths::Combine(Settings.ImageOutputDirectory.Path, TEXT("Thumbnails.ttc"));
+
+			{
+				FThumbnailToTextureExporter WarmUpExporter;
+				WarmUpExporter.SetUseDerivedDataCache(false);
+				WarmUpExporter.ExportAssets(TArray<FAssetData>(Assets.GetData(), FMath::Min(Assets.Num(), ThumbnailToTextureBenchmark::NumWarmUpAssets)));
+			}
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+			const FPlatformMemoryStats MemoryBefore = FPlatformMemory::GetStats();
+			const FThumbnailExportPhaseTotals PhasesBefore = ThumbnailToTextureStats::GetPhaseTotals();
+
+			FThumbnailToTextureExporter Exporter;
+			Exporter.SetUseDerivedDataCache(Switches.Contains(TEXT("UseDDC")));
+			const FThumbnailExportStats Stats = Exporter.ExportAssets(Assets);
+
+			const FThumbnailExportPhaseTotals Phases = ThumbnailToTextureStats::GetPhaseTotals() - PhasesBefore;
+			const FPlatformMemoryStats MemoryAfter = FPlatformMemory::GetStats();
+
+			UE_LOG(LogThumbnailToTexture, Display, TEXT("Benchmark mode %s:"), Mode.Name);
+			Stats.LogSummary();
+			bSucceeded &= Stats.NumFailed == 0;
+
+			TSharedRef<FJsonObject> ModeObject = MakeShared<FJsonObject>();
+			ModeObject->SetStringField(TEXT("Name"), Mode.Name);
+			ModeObject->SetNumberField(TEXT("NumAssets"), Stats.NumRequested);
+			ModeObject->SetNumberField(TEXT("NumExported"), Stats.NumExported);
+			ModeObject->SetNumberField(TEXT("NumRendered"), Stats.NumRendered);
+			ModeObject->SetNumberField(TEXT("NumFailed"), Stats.NumFailed);
+			ModeObject->SetNumberField(TEXT("AssetsPerSecond"), Stats.GetAssetsPerSecond());
+			// Each impostor draws a view per cell of its grid in each of its layers
+			const int32 NumViewsPerAsset = Settings.ImpostorGridSize > 0 ? Settings.ImpostorGridSize * Settings.ImpostorGridSize * FThumbnailImpostorLayout::NumRenderedLayers : 1;
+			ModeObject->SetNumberField(TEXT("ImpostorGridSize"), Settings.ImpostorGridSize);
+			ModeObject->SetStringField(TEXT("OutputFormat"), StaticEnum<EThumbnailOutputFormat>()->GetNameStringByValue(static_cast<int64>(Settings.OutputFormat)));
+			ModeObject->SetNumberField(TEXT("ViewsPerSecond"), Stats.ExportTimeSeconds > 0.0 ? Stats.NumRendered * NumViewsPerAsset / Stats.ExportTimeSeconds : 0.0);
+			ModeObject->SetNumberField(TEXT("WallTimeSeconds"), Stats.WallTimeSeconds);
+			ModeObject->SetNumberField(TEXT("ExportTimeSeconds"), Stats.ExportTimeSeconds);
+			ModeObject->SetNumberField(TEXT("TextureCompileWaitSeconds"), Stats.TextureCompileWaitSeconds);
+			ModeObject->SetNumberField(TEXT("SaveTimeSeconds"), Stats.SaveTimeSeconds);
+			ModeObject->SetNumberField(TEXT("ExportMillisecondsPerAsset"), Stats.NumExported > 0 ? 1000.0 * Stats.ExportTimeSeconds / Stats.NumExported : 0.0);
+			ModeObject->SetNumberField(TEXT("NumTexturesCompiledInBackground"), Stats.NumTexturesCompiledInBackground);
+			ModeObject->SetNumberField(TEXT("NumTexturesCompiledAtEnd"), Stats.NumTexturesCompiledAtEnd);
+			ModeObject->SetNumberField(TEXT("NumDerivedDataCacheHits"), Stats.NumDerivedDataCacheHits);
+			ModeObject->SetNumberField(TEXT("NumShaderCompileDeferrals"), Stats.NumShaderCompileDeferrals);
+			ModeObject->SetNumberField(TEXT("StreamingWaitSeconds"), Stats.StreamingWaitSeconds);
+			ModeObject->SetNumberField(TEXT("NumStreamingTimeouts"), Stats.NumStreamingTimeouts);
+			ModeObject->SetNumberField(TEXT("UsedPhysicalMBBefore"), ThumbnailToTextureBenchmark::ToMegabytes(MemoryBefore.UsedPhysical));
+			ModeObject->SetNumberField(TEXT("UsedPhysicalMBAfter"), ThumbnailToTextureBenchmark::ToMegabytes(MemoryAfter.UsedPhysical));
+			// What the export still holds once done, the exporter's render targets and preview scenes and the module's caches.
+			// The process peak isn't reported, it covers the content creation and the modes run before this one
+			ModeObject->SetNumberField(TEXT("UsedPhysicalDeltaMB"), (static_cast<double>(MemoryAfter.UsedPhysical) - static_cast<double>(MemoryBefore.UsedPhysical)) / (1024.0 * 1024.0));
+
+			// Time spent in each phase on every thread, so a regression can be pinned on a phase rather than on the total
+			TArray<TSharedPtr<FJsonValue>> PhaseValues;
+			for (int32 Phase = 0; Phase < static_cast<int32>(EThumbnailExportPhase::Num); ++Phase)
+			{
+				TSharedRef<FJsonObject> PhaseObject = MakeShared<FJsonObject>();
+				PhaseObject->SetStringField(TEXT("Name"), ThumbnailToTextureStats::GetPhaseName(static_cast<EThumbnailExportPhase>(Phase)));
+				PhaseObject->SetNumberField(TEXT("Seconds"), Phases.Seconds[Phase]);
+				PhaseObject->SetNumberField(TEXT("NumItems"), Phases.NumItems[Phase]);
+				PhaseObject->SetNumberField(TEXT("MillisecondsPerItem"), Phases.NumItems[Phase] > 0 ? 1000.0 * Phases.Seconds[Phase] / Phases.NumItems[Phase] : 0.0);
+				PhaseValues.Add(MakeShared<FJsonValueObject>(PhaseObject));
+			}
+			ModeObject->SetArrayField(TEXT("Phases"), PhaseValues);
+			ModeValues.Add(MakeShared<FJsonValueObject>(ModeObject));
+
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		}
+		Root->SetArrayField(TEXT("Modes"), ModeValues);
+
+		Settings.UseCustomBackgroundMaterial = bSavedUseCustomBackgroundMaterial;
+		Settings.UseTransparentBackground = bSavedUseTransparentBackground;
+		Settings.BackgroundMaterial = SavedBackgroundMaterial;
+		Settings.RootTexture2DSaveDir = SavedRootTexture2DSaveDir;
+		Settings.ImpostorGridSize = SavedImpostorGridSize;
+		Settings.OutputFormat = SavedOutputFormat;
+		Settings.ImageOutputDirectory = SavedImageOutputDirectory;
+		Settings.ContainerFile = SavedContainerFile;
+
+		if (!Switches.Contains(TEXT("KeepContent")))
+		{
+			DeleteContent();
+		}
+	}
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Root, Writer);
+	if (!FFileHelper::SaveStringToFile(Json, *OutputFilename))
+	{
+		UE_LOG(LogThumbnailToTexture, Error, TEXT("Couldn't write the benchmark results to %s"), *OutputFilename);
+		return 1;
+	}
+
+	UE_LOG(LogThumbnailToTexture, Display, TEXT("Benchmark results written to %s"), *OutputFilename);
+	return bSucceeded ? 0 : 1;
+}
+
+bool UThumbnailToTextureBenchmarkCommandlet::CreateContent(int32 NumStaticMeshes, int32 NumBlueprints, int32 MaxComponents, TArray<FAssetData>& OutAssets)
+{
+	TArray<UStaticMesh*> StaticMeshes;
+	for (int32 Index = 0; Index < NumStaticMeshes; ++Index)
+	{
+		// From 8 to 256 segments, 32 to 32K triangles
+		const int32 NumSegments = 8 << (Index % 6);
+		UStaticMesh* StaticMesh = CreateStaticMesh(FString::Printf(TEXT("%s/Content/SM_Benchmark_%03d"), ThumbnailToTextureBenchmark::RootPath, Index), NumSegments);
+		if (!StaticMesh || !SaveAsset(StaticMesh))
+		{
+			return false;
+		}
+		StaticMeshes.Add(StaticMesh);
+		OutAssets.Emplace(StaticMesh);
+	}
+
+	if (StaticMeshes.Num() == 0)
+	{
+		StaticMeshes.Add(CreateStaticMesh(FString::Printf(TEXT("%s/Content/SM_Benchmark_Component"), ThumbnailToTextureBenchmark::RootPath), 16));
+		if (!StaticMeshes[0] || !SaveAsset(StaticMeshes[0]))
+		{
+			return false;
+		}
+	}
+
+	for (int32 Index = 0; Index < NumBlueprints; ++Index)
+	{
+		const int32 NumComponents = 1 + Index % MaxComponents;
+		UBlueprint* Blueprint = CreateBlueprint(FString::Printf(TEXT("%s/Content/BP_Benchmark_%03d"), ThumbnailToTextureBenchmark::RootPath, Index), StaticMeshes, NumComponents);
+		if (!Blueprint || !SaveAsset(Blueprint))
+		{
+			return false;
+		}
+		OutAssets.Emplace(Blueprint);
+	}
+
+	UE_LOG(LogThumbnailToTexture, Display, TEXT("Created %d static meshes and %d blueprints to export"), NumStaticMeshes, NumBlueprints);
+	return true;
+}
+
+UStaticMesh* UThumbnailToTextureBenchmarkCommandlet::CreateStaticMesh(const FString& PackageName, int32 NumSegments)
+{
+	UPackage* Package = CreatePackage(*PackageName);
+	UStaticMesh* StaticMesh = NewObject<UStaticMesh>(Package, *FPackageName::GetShortName(PackageName), RF_Public | RF_Standalone);
+	StaticMesh->GetStaticMaterials().Add(FStaticMaterial(UMaterial::GetDefaultMaterial(MD_Surface)));
+	StaticMesh->AddSourceModel();
+
+	FMeshDescription* MeshDescription = StaticMesh->CreateMeshDescription(0);
+	FStaticMeshAttributes Attributes(*MeshDescription);
+	Attributes.Register();
+
+	FMeshDescriptionBuilder Builder;
+	Builder.SetMeshDescription(MeshDescription);
+	Builder.EnablePolyGroups();
+	Builder.SetNumUVLayers(1);
+	const FPolygonGroupID PolygonGroup = Builder.AppendPolygonGroup();
+
+	const int32 NumRings = FMath::Max(2, NumSegments / 2);
+	constexpr double Radius = 50.0;
+
+	TArray<FVertexInstanceID> VertexInstances;
+	VertexInstances.Reserve((NumRings + 1) * (NumSegments + 1));
+	for (int32 Ring = 0; Ring <= NumRings; ++Ring)
+	{
+		const double Theta = PI * Ring / NumRings;
+		for (int32 Segment = 0; Segment <= NumSegments; ++Segment)
+		{
+			const double Phi = 2.0 * PI * Segment / NumSegments;
+			const FVector Normal(FMath::Sin(Theta) * FMath::Cos(Phi), FMath::Sin(Theta) * FMath::Sin(Phi), FMath::Cos(Theta));
+
+			const FVertexInstanceID VertexInstance = Builder.AppendInstance(Builder.AppendVertex(Normal * Radius));
+			Builder.SetInstanceNormal(VertexInstance, Normal);
+			Builder.SetInstanceUV(VertexInstance, FVector2D(static_cast<double>(Segment) / NumSegments, static_cast<double>(Ring) / NumRings), 0);
+			VertexInstances.Add(VertexInstance);
+		}
+	}
+
+	for (int32 Ring = 0; Ring < NumRings; ++Ring)
+	{
+		for (int32 Segment = 0; Segment < NumSegments; ++Segment)
+		{
+			const int32 Corner = Ring * (NumSegments + 1) + Segment;
+			const int32 Below = Corner + NumSegments + 1;
+			Builder.AppendTriangle(VertexInstances[Corner], VertexInstances[Corner + 1], VertexInstances[Below], PolygonGroup);
+			Builder.AppendTriangle(VertexInstances[Corner + 1], VertexInstances[Below + 1], VertexInstances[Below], PolygonGroup);
+		}
+	}
+
+	StaticMesh->CommitMeshDescription(0);
+	constexpr bool bSilent = true;
+	// Builds the render data, PostEditChange() would build it a second time
+	StaticMesh->Build(bSilent);
+	FAssetRegistryModule::AssetCreated(StaticMesh);
+	return StaticMesh;
+}
+
+UBlueprint* UThumbnailToTextureBenchmarkCommandlet::CreateBlueprint(const FString& PackageName, TArrayView<UStaticMesh* const> StaticMeshes, int32 NumComponents)
+{
+	UPackage* Package = CreatePackage(*PackageName);
+	UBlueprint* Blueprint = FKismetEditorUtilities::CreateBlueprint(AActor::StaticClass(), Package, *FPackageName::GetShortName(PackageName),
+		BPTYPE_Normal, UBlueprint::StaticClass(), UBlueprintGeneratedClass::StaticClass());
+	if (!Blueprint || !Blueprint->SimpleConstructionScript)
+	{
+		return nullptr;
+	}
+
+	for (int32 ComponentIndex = 0; ComponentIndex < NumComponents; ++ComponentIndex)
+	{
+		USCS_Node* Node = Blueprint->SimpleConstructionScript->CreateNode(UStaticMeshComponent::StaticClass(), *FString::Printf(TEXT("Mesh%d"), ComponentIndex));
+		UStaticMeshComponent* Component = CastChecked<UStaticMeshComponent>(Node->ComponentTemplate);
+		Component->SetStaticMesh(StaticMeshes[ComponentIndex % StaticMeshes.Num()]);
+		Component->SetRelativeLocation(FVector(ComponentIndex * 120.0, 0.0, 0.0));
+		Blueprint->SimpleConstructionScript->AddNode(Node);
+	}
+
+	FKismetEditorUtilities::CompileBlueprint(Blueprint);
+	FAssetRegistryModule::AssetCreated(Blueprint);
+	return Blueprint;
+}
+
+bool UThumbnailToTextureBenchmarkCommandlet::SaveAsset(UObject* Asset)
+{
+	// Saved in the package, exported as is by the Cached mode
+	ThumbnailTools::GenerateThumbnailForObjectToSaveToDisk(Asset);
+
+	UPackage* Package = Asset->GetPackage();
+	const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+	SaveArgs.SaveFlags = SAVE_NoError;
+	SaveArgs.Error = GWarn;
+	return UPackage::SavePackage(Package, Asset, *Filename, SaveArgs);
+}
+
+bool UThumbnailToTextureBenchmarkCommandlet::GatherContent(const FString& ContentPath, TArray<FAssetData>& OutAssets)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	FARFilter Filter;
+	Filter.PackagePaths.Add(*ContentPath);
+	Filter.bRecursivePaths = true;
+	Filter.ClassPaths.Add(UStaticMesh::StaticClass()->GetClassPathName());
+	Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
+	AssetRegistry.GetAssets(Filter, OutAssets);
+
+	// Same order on every run, the batches then hold the same assets
+	OutAssets.Sort([](const FAssetData& A, const FAssetData& B) { return A.PackageName.LexicalLess(B.PackageName); });
+	return OutAssets.Num() > 0;
+}
+
+void UThumbnailToTextureBenchmarkCommandlet::DeleteContent()
+{
+	const FString Directory = FPackageName::LongPackageNameToFilename(ThumbnailToTextureBenchmark::RootPath);
+	constexpr bool bRequireExists = false;
+	constexpr bool bTree = true;
+	IFileManager::Get().DeleteDirectory(*Directory, bRequireExists, bTree);
+}
+
+TSharedRef<FJsonObject> UThumbnailToTextureBenchmarkCommandlet::BenchmarkContainer(int32 NumEntries, int32 NumLookups, bool bKeepContainer, bool& bOutValid)
+{
+	NumEntries = FMath::Max(NumEntries, 1);
+	const FString Filename = FPaths::ProjectSavedDir() / TEXT("ThumbnailToTexture") / TEXT("BenchmarkContainer.ttc");
+	IFileManager::Get().Delete(*Filename, false, true, true);
+
+	// Each thumbnail is filled with a color made from its index, so a lookup can tell it found the right one
+	auto GetAssetPath = [](int32 Index)
+	{
+		return FString::Printf(TEXT("/Game/ThumbnailToTextureBenchmark/Content/SM_Benchmark_%06d.SM_Benchmark_%06d"), Index, Index);
+	};
+	auto GetColor = [](int32 Index)
+	{
+		return FColor(Index & 0xFF, (Index >> 8) & 0xFF, (Index >> 16) & 0xFF, 255);
+	};
+
+	const FIntPoint Size(ThumbnailToTextureBenchmark::ContainerEntrySize);
+	double WriteSeconds = 0.0;
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		FThumbnailContainerWriter Writer(Filename, EThumbnailContainerEntryFormat::BGRA8);
+		bOutValid &= Writer.Open();
+		for (int32 Index = 0; Index < NumEntries; ++Index)
+		{
+			TArray<FColor> Pixels;
+			Pixels.Init(GetColor(Index), Size.X * Size.Y);
+			Writer.Add(GetAssetPath(Index), Size, MoveTemp(Pixels));
+		}
+		bOutValid &= Writer.Commit();
+		WriteSeconds = FPlatformTime::Seconds() - StartTime;
+	}
+
+	FThumbnailContainerReader Reader;
+	double OpenSeconds = 0.0;
+	for (int32 Open = 0; Open < ThumbnailToTextureBenchmark::NumContainerOpens; ++Open)
+	{
+		Reader.Close();
+		const double StartTime = FPlatformTime::Seconds();
+		bOutValid &= Reader.Open(Filename);
+		OpenSeconds += FPlatformTime::Seconds() - StartTime;
+	}
+	OpenSeconds /= ThumbnailToTextureBenchmark::NumContainerOpens;
+	bOutValid &= Reader.Num() == NumEntries;
+
+	// Paths are made before timing, hashing them is part of the lookup
+	constexpr int32 NumLookupPaths = 4096;
+	FRandomStream Random(NumEntries);
+	TArray<FString> LookupPaths;
+	TArray<int32> LookupIndices;
+	for (int32 Index = 0; Index < NumLookupPaths; ++Index)
+	{
+		LookupIndices.Add(Random.RandRange(0, NumEntries - 1));
+		LookupPaths.Add(GetAssetPath(LookupIndices.Last()));
+	}
+
+	// Reading the first pixel pages the thumbnail in, as a caller drawing it would
+	int32 NumMismatches = 0;
+	const double LookupStartTime = FPlatformTime::Seconds();
+	for (int32 Lookup = 0; Lookup < NumLookups; ++Lookup)
+	{
+		const int32 PathIndex = Lookup % NumLookupPaths;
+		FThumbnailContainerEntry Entry;
+		if (!Reader.Find(LookupPaths[PathIndex], Entry) || Entry.Size != Size
+			|| reinterpret_cast<const FColor*>(Entry.Data.GetData())[0] != GetColor(LookupIndices[PathIndex]))
+		{
+			++NumMismatches;
+		}
+	}
+	const double LookupSeconds = FPlatformTime::Seconds() - LookupStartTime;
+	bOutValid &= NumMismatches == 0;
+
+	const int64 FileSize = IFileManager::Get().FileSize(*Filename);
+	Reader.Close();
+	if (!bKeepContainer)
+	{
+		IFileManager::Get().Delete(*Filename);
+	}
+
+	const double LookupNanoseconds = NumLookups > 0 ? 1e9 * LookupSeconds / NumLookups : 0.0;
+	UE_LOG(LogThumbnailToTexture, Display, TEXT("Container: %d entries, %.1f MB written at %.0f entries/s, opened in %.3f ms, %.0f ns per lookup, %d wrong lookups"),
+		NumEntries, ThumbnailToTextureBenchmark::ToMegabytes(FMath::Max<int64>(FileSize, 0)), WriteSeconds > 0.0 ? NumEntries / WriteSeconds : 0.0,
+		1000.0 * OpenSeconds, LookupNanoseconds, NumMismatches);
+
+	TSharedRef<FJsonObject> ContainerObject = MakeShared<FJsonObject>();
+	ContainerObject->SetNumberField(TEXT("NumEntries"), NumEntries);
+	ContainerObject->SetNumberField(TEXT("FileSizeMB"), ThumbnailToTextureBenchmark::ToMegabytes(FMath::Max<int64>(FileSize, 0)));
+	ContainerObject->SetNumberField(TEXT("EntriesWrittenPerSecond"), WriteSeconds > 0.0 ? NumEntries / WriteSeconds : 0.0);
+	ContainerObject->SetNumberField(TEXT("OpenMilliseconds"), 1000.0 * OpenSeconds);
+	ContainerObject->SetNumberField(TEXT("NumLookups"), NumLookups);
+	ContainerObject->SetNumberField(TEXT("LookupNanoseconds"), LookupNanoseconds);
+	ContainerObject->SetNumberField(TEXT("NumWrongLookups"), NumMismatches);
+	return ContainerObject;
+}
+
+TSharedRef<FJsonObject> UThumbnailToTextureBenchmarkCommandlet::DescribeEnvironment()
+{
+	TSharedRef<FJsonObject> Environment = MakeShared<FJsonObject>();
+
+	const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("ThumbnailToTextureTool"));
+	Environment->SetStringField(TEXT("PluginVersion"), Plugin.IsValid() ? Plugin->GetDescriptor().VersionName : FString());
+	Environment->SetStringField(TEXT("EngineVersion"), FEngineVersion::Current().ToString());
+	Environment->SetStringField(TEXT("Platform"), FPlatformProperties::IniPlatformName());
+	Environment->SetStringField(TEXT("CPU"), FPlatformMisc::GetCPUBrand().TrimStartAndEnd());
+	Environment->SetNumberField(TEXT("NumCores"), FPlatformMisc::NumberOfCores());
+	Environment->SetNumberField(TEXT("NumLogicalCores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+	Environment->SetStringField(TEXT("RHI"), GDynamicRHI ? GDynamicRHI->GetName() : TEXT("None"));
+	Environment->SetStringField(TEXT("GPU"), GRHIAdapterName);
+	Environment->SetNumberField(TEXT("TotalPhysicalMB"), FPlatformMemory::GetConstants().TotalPhysicalGB * 1024.0);
+
+	const UThumbnailToTextureSettings& Settings = IThumbnailToTextureToolModule::GetEditorSettings();
+	Environment->SetNumberField(TEXT("ThumbnailResolution"), Settings.ThumbnailResolution);
+	Environment->SetNumberField(TEXT("SupersampleFactor"), Settings.SupersampleFactor);
+	Environment->SetNumberField(TEXT("MaxBatchSize"), Settings.MaxBatchSize);
+	Environment->SetNumberField(TEXT("NumReadbacksInFlight"), Settings.NumReadbacksInFlight);
+	return Environment;
+}
@@ -0,0 +1,197 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailToTextureCommandlet.h"
+
+#include "IThumbnailToTextureTool.h"
+#include "ThumbnailExportManifest.h"
+#include "ThumbnailToTextureExporter.h"
+#include "ThumbnailToTextureSettings.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+
+UThumbnailToTextureCommandlet::UThumbnailToTextureCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UThumbnailToTextureCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	TArray<FAssetData> Assets;
+	if (!GatherAssets(ParamVals, Assets))
+	{
+		return 1;
+	}
+
+	if (Assets.Num() == 0)
+	{
+		UE_LOG(LogThumbnailToTexture, Warning, TEXT("No asset to export, use -Paths, -Assets or -Manifest"));
+		return 0;
+	}
+
+	// Rendering in a commandlet requires -AllowCommandletRendering, otherwise use the thumbnails cached in the packages
+	const bool bCachedOnly = Switches.Contains(TEXT("CachedOnly")) || !FApp::CanEverRender();
+	if (bCachedOnly)
+	{
+		UE_LOG(LogThumbnailToTexture, Display, TEXT("Rendering is unavailable or disabled, exporting the thumbnails cached in the packages"));
+	}
+
+	// The settings constructor skips loading assets when running a commandlet
+	IThumbnailToTextureToolModule::GetEditorSettings().LoadTranslucentMaterial();
+
+	UE_LOG(LogThumbnailToTexture, Display, TEXT("Exporting the thumbnails of %d assets"), Assets.Num());
+
+	FThumbnailToTextureExporter Exporter;
+	Exporter.SetForceCachedThumbnails(bCachedOnly);
+	Exporter.SetUseDerivedDataCache(!Switches.Contains(TEXT("NoDDC")));
+
+	// Nightly runs only export what changed
+	if (!Switches.Contains(TEXT("Full")))
+	{
+		const FString* ManifestParam = ParamVals.Find(TEXT("ExportManifest"));
+		Exporter.EnableIncrementalExport(ManifestParam ? *ManifestParam : FThumbnailExportManifest::GetDefaultFilename());
+	}
+
+	const FThumbnailExportStats Stats = Exporter.ExportAssets(Assets);
+	Stats.LogSummary();
+
+	return Stats.NumFailed == 0 ? 0 : 1;
+}
+
+bool UThumbnailToTextureCommandlet::GatherAssets(const TMap<FString, FString>& ParamVals, TArray<FAssetData>& OutAssets) const
+{
+	TArray<FString> AssetPaths;
+	TArray<FString> FolderPaths;
+
+	if (const FString* AssetsParam = ParamVals.Find(TEXT("Assets")))
+	{
+		AssetsParam->ParseIntoArray(AssetPaths, TEXT("+"));
+	}
+
+	if (const FString* PathsParam = ParamVals.Find(TEXT("Paths")))
+	{
+		PathsParam->ParseIntoArray(FolderPaths, TEXT("+"));
+	}
+
+	if (const FString* ManifestParam = ParamVals.Find(TEXT("Manifest")))
+	{
+		if (!ReadManifest(*ManifestParam, AssetPaths, FolderPaths))
+		{
+			return false;
+		}
+	}
+
+	TArray<FTopLevelAssetPath> ClassPaths;
+	if (const FString* ClassesParam = ParamVals.Find(TEXT("Classes")))
+	{
+		TArray<FString> ClassNames;
+		ClassesParam->ParseIntoArray(ClassNames, TEXT("+"));
+		for (const FString& ClassName : ClassNames)
+		{
+			const UClass* Class = ClassName.StartsWith(TEXT("/"))
+				                      ? FindObject<UClass>(nullptr, *ClassName)
+				                      : UClass::TryFindTypeSlow<UClass>(ClassName);
+			if (!Class)
+			{
+				UE_LOG(LogThumbnailToTexture, Error, TEXT("Unknown class %s"), *ClassName);
+				return false;
+			}
+			ClassPaths.Add(Class->GetClassPathName());
+		}
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	for (const FString& AssetPath : AssetPaths)
+	{
+		FAssetData AssetData = AssetRegistry.GetAssetByObjectPath(FSoftObjectPath(AssetPath));
+		if (!AssetData.IsValid())
+		{
+			UE_LOG(LogThumbnailToTexture, Error, TEXT("Couldn't find asset %s"), *AssetPath);
+			return false;
+		}
+		OutAssets.Add(MoveTemp(AssetData));
+	}
+
+	if (FolderPaths.Num() > 0)
+	{
+		FARFilter Filter;
+		Filter.bRecursivePaths = true;
+		Filter.bRecursiveClasses = true;
+		for (const FString& FolderPath : FolderPaths)
+		{
+			Filter.PackagePaths.Add(FName(FolderPath.EndsWith(TEXT("/")) ? FolderPath.LeftChop(1) : FolderPath));
+		}
+		Filter.ClassPaths = ClassPaths;
+
+		AssetRegistry.GetAssets(Filter, OutAssets);
+	}
+
+	if (ClassPaths.Num() > 0)
+	{
+		// Explicit asset paths also go through the class filter
+		OutAssets.RemoveAll([&ClassPaths, &AssetRegistry](const FAssetData& AssetData)
+		{
+			TArray<FTopLevelAssetPath> Ancestors;
+			AssetRegistry.GetAncestorClassNames(AssetData.AssetClassPath, Ancestors);
+			Ancestors.Add(AssetData.AssetClassPath);
+			return !Ancestors.ContainsByPredicate([&ClassPaths](const FTopLevelAssetPath& Ancestor)
+			{
+				return ClassPaths.Contains(Ancestor);
+			});
+		});
+	}
+
+	// An asset may be listed by several sources
+	TSet<FSoftObjectPath> UniqueAssets;
+	OutAssets.RemoveAll([&UniqueAssets](const FAssetData& AssetData)
+	{
+		bool bAlreadyInSet = false;
+		UniqueAssets.Add(AssetData.GetSoftObjectPath(), &bAlreadyInSet);
+		return bAlreadyInSet;
+	});
+
+	return true;
+}
+
+bool UThumbnailToTextureCommandlet::ReadManifest(const FString& ManifestFilename, TArray<FString>& OutAssetPaths, TArray<FString>& OutFolderPaths)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *ManifestFilename))
+	{
+		UE_LOG(LogThumbnailToTexture, Error, TEXT("Couldn't read manifest %s"), *ManifestFilename);
+		return false;
+	}
+
+	for (FString& Line : Lines)
+	{
+		Line.TrimStartAndEndInline();
+		if (Line.IsEmpty() || Line.StartsWith(TEXT("#")))
+		{
+			continue;
+		}
+
+		// Object paths have a '.' after the package name, folders don't
+		if (Line.Contains(TEXT(".")))
+		{
+			OutAssetPaths.Add(MoveTemp(Line));
+		}
+		else
+		{
+			OutFolderPaths.Add(MoveTemp(Line));
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,1361 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailToTextureExporter.h"
+
+#include "CanvasTypes.h"
+#include "CustomBlueprintRenderer.h"
+#include "CustomStaticMeshThumbnailRenderer.h"
+#include "FileHelpers.h"
+#include "ISourceControlModule.h"
+#include "ISourceControlProvider.h"
+#include "IThumbnailToTextureTool.h"
+#include "ObjectTools.h"
+#include "PackageTools.h"
+#include "SourceControlHelpers.h"
+#include "ThumbnailContainerWriter.h"
+#include "ThumbnailDerivedData.h"
+#include "ThumbnailExportManifest.h"
+#include "ThumbnailImageUtils.h"
+#include "ThumbnailImageWriter.h"
+#include "ThumbnailReadbackRing.h"
+#include "ThumbnailRenderTargetPool.h"
+#include "ThumbnailToTextureSettings.h"
+#include "ThumbnailToTextureStats.h"
+#include "ThumbnailTurntableLayout.h"
+#include "TextureCompiler.h"
+#include "UnrealEdGlobals.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "MaterialShared.h"
+#include "ShaderCompiler.h"
+#include "Editor/UnrealEdEngine.h"
+#include "Engine/Blueprint.h"
+#include "Engine/SCS_Node.h"
+#include "Engine/SimpleConstructionScript.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/Texture2D.h"
+#include "Materials/MaterialInterface.h"
+#include "Misc/App.h"
+#include "Misc/Paths.h"
+#include "UObject/SavePackage.h"
+#include "ThumbnailRendering/BlueprintThumbnailRenderer.h"
+#include "ThumbnailRendering/StaticMeshThumbnailRenderer.h"
+#include "ThumbnailRendering/ThumbnailManager.h"
+
+DEFINE_LOG_CATEGORY(LogThumbnailToTexture);
+
+namespace ThumbnailToTextureExporter
+{
+	/** Cached thumbnails read together, enough packages to keep every core busy while bounding the decompressed images in memory */
+	constexpr int32 MaxCachedReadsPerFlush = 256;
+
+	/** Image files encoded at once, the renders wait for the oldest write above it so the pixels handed to the workers stay bounded */
+	constexpr int32 MaxImageWritesInFlight = 64;
+
+	/** Materials drawn in the thumbnail of the assets the custom renderers support */
+	void GatherUsedMaterials(UObject* Object, TArray<UMaterialInterface*>& OutMaterials)
+	{
+		TArray<UMaterialInterface*> ComponentMaterials;
+		auto AddComponentMaterials = [&ComponentMaterials, &OutMaterials](const UPrimitiveComponent* Component)
+		{
+			ComponentMaterials.Reset();
+			Component->GetUsedMaterials(ComponentMaterials);
+			for (UMaterialInterface* Material : ComponentMaterials)
+			{
+				OutMaterials.AddUnique(Material);
+			}
+		};
+
+		if (const UStaticMesh* StaticMesh = Cast<UStaticMesh>(Object))
+		{
+			for (const FStaticMaterial& StaticMaterial : StaticMesh->GetStaticMaterials())
+			{
+				OutMaterials.AddUnique(StaticMaterial.MaterialInterface);
+			}
+		}
+		else if (const UBlueprint* Blueprint = Cast<UBlueprint>(Object))
+		{
+			// Components added by the blueprint, then the ones of the native parent class
+			if (Blueprint->SimpleConstructionScript)
+			{
+				for (const USCS_Node* Node : Blueprint->SimpleConstructionScript->GetAllNodes())
+				{
+					if (const UPrimitiveComponent* Component = Node ? Cast<UPrimitiveComponent>(Node->ComponentTemplate) : nullptr)
+					{
+						AddComponentMaterials(Component);
+					}
+				}
+			}
+
+			if (const AActor* DefaultActor = Blueprint->GeneratedClass ? Cast<AActor>(Blueprint->GeneratedClass->GetDefaultObject()) : nullptr)
+			{
+				DefaultActor->ForEachComponent<UPrimitiveComponent>(false, AddComponentMaterials);
+			}
+		}
+
+		OutMaterials.Remove(nullptr);
+	}
+
+	/** @return true if the shader map the material renders with at the current feature level is still compiling */
+	bool IsShaderMapCompiling(UMaterialInterface* Material)
+	{
+		const FMaterialResource* Resource = Material ? Material->GetMaterialResource(GMaxRHIFeatureLevel) : nullptr;
+		return Resource && !Resource->IsCompilationFinished();
+	}
+}
+
+double FThumbnailExportStats::GetAssetsPerSecond() const
+{
+	return WallTimeSeconds > 0.0 ? NumExported / WallTimeSeconds : 0.0;
+}
+
+void FThumbnailExportStats::LogSummary() const
+{
+	UE_LOG(LogThumbnailToTexture, Display, TEXT("Thumbnail export: %d requested, %d exported (%d rendered), %d skipped as unchanged, %d failed, %d unsupported in %.2fs (%.2f assets/sec, %.2fs saving)"),
+		NumRequested, NumExported, NumRendered, NumSkipped, NumFailed, NumUnsupported, WallTimeSeconds, GetAssetsPerSecond(), SaveTimeSeconds);
+
+	if (NumRenderTargetPoolHits + NumRenderTargetPoolMisses > 0)
+	{
+		UE_LOG(LogThumbnailToTexture, Display, TEXT("Render target pool: %d hits, %d misses"), NumRenderTargetPoolHits, NumRenderTargetPoolMisses);
+	}
+
+	if (const int32 NumLookups = NumDerivedDataCacheHits + NumDerivedDataCacheMisses; NumLookups > 0)
+	{
+		UE_LOG(LogThumbnailToTexture, Display, TEXT("Derived Data Cache: %d hits, %d misses (%.1f%% hit rate)"),
+			NumDerivedDataCacheHits, NumDerivedDataCacheMisses, 100.0 * NumDerivedDataCacheHits / NumLookups);
+	}
+
+	if (NumShaderCompileDeferrals > 0)
+	{
+		UE_LOG(LogThumbnailToTexture, Display, TEXT("Shader compilation: %d assets drawn once the shaders of their materials were compiled"), NumShaderCompileDeferrals);
+	}
+
+	if (StreamingWaitSeconds > 0.0 || NumStreamingTimeouts > 0)
+	{
+		UE_LOG(LogThumbnailToTexture, Display, TEXT("Texture streaming: %.2fs waiting for mips, %d assets rendered before all of theirs were resident"),
+			StreamingWaitSeconds, NumStreamingTimeouts);
+	}
+
+	UE_LOG(LogThumbnailToTexture, Display, TEXT("Phases: %.2fs exporting, %.2fs waiting for textures to compile, %.2fs saving. %d textures compiled while exporting, %d still compiling at the end"),
+		ExportTimeSeconds, TextureCompileWaitSeconds, SaveTimeSeconds, NumTexturesCompiledInBackground, NumTexturesCompiledAtEnd);
+
+	for (const FString& FailedAsset : FailedAssets)
+	{
+		UE_LOG(LogThumbnailToTexture, Warning, TEXT("Failed to export thumbnail of %s"), *FailedAsset);
+	}
+}
+
+FThumbnailToTextureExporter::FThumbnailToTextureExporter()
+	: Settings(IThumbnailToTextureToolModule::GetEditorSettings().MakeSnapshot())
+	, TurntableLayout(Settings->NumTurntableFrames)
+	, ImpostorLayout(Settings->ImpostorGridSize, Settings->bImpostorFullSphere)
+	, NumImageWritesWaited(0)
+	, PendingBatchRenderer(EBatchRenderer::None)
+	, PendingBatchOtherRenderer(nullptr)
+	, BatchSize(1)
+	, TileSize(ThumbnailTools::DefaultThumbnailSize)
+	, SupersampleFactor(1)
+	, NumDerivedDataCacheHits(0)
+	, NumDerivedDataCacheMisses(0)
+	, NumShaderCompileDeferrals(0)
+	, StreamingWaitSeconds(0.0)
+	, NumStreamingTimeouts(0)
+	, ExportStartTime(0.0)
+	, StartDerivedDataCacheHits(0)
+	, StartDerivedDataCacheMisses(0)
+	, StartNumShaderCompileDeferrals(0)
+	, StartStreamingWaitSeconds(0.0)
+	, StartNumStreamingTimeouts(0)
+	, NextRequestId(0)
+	, bForceCachedThumbnails(false)
+	, bUseDerivedDataCache(true)
+	, bPersistentScenes(false)
+{
+}
+
+FThumbnailToTextureExporter::~FThumbnailToTextureExporter()
+{
+	// Textures of renders and reads still queued or in flight are left out of the batch
+	PendingBatch.Reset();
+	DeferredRenders.Reset();
+	PendingCachedReads.Reset();
+	ReadbackRing.Reset();
+
+	// Nothing would ever clear their RF_Standalone. During exit purge they may already be gone
+	if (!GExitPurge)
+	{
+		TArray<UPackage*> PackagesToRestore;
+		for (TPair<int32, FPendingPackage>& InFlight : InFlightRenders)
+		{
+			DiscardTexture(InFlight.Value, PackagesToRestore);
+		}
+		for (FPendingPackage& Pending : PendingCachedPackages)
+		{
+			DiscardTexture(Pending, PackagesToRestore);
+		}
+		RestorePackages(PackagesToRestore);
+	}
+	InFlightRenders.Reset();
+	PendingCachedPackages.Reset();
+
+	// The workers still encoding use the image wrappers
+	for (FPendingPackage& Pending : PendingImageWrites)
+	{
+		Pending.ImageWrite.Wait();
+	}
+	PendingImageWrites.Reset();
+	ContainerWriter.Reset();
+
+	// During exit purge the renderers may already be gone
+	if (!GExitPurge)
+	{
+		EndPersistentScenes();
+	}
+}
+
+void FThumbnailToTextureExporter::BeginPersistentScenes()
+{
+	if (!bPersistentScenes)
+	{
+		IThumbnailToTextureToolModule::GetCustomBlueprintThumbnailRenderer().BeginPersistentScene();
+		IThumbnailToTextureToolModule::GetCustomStaticMeshThumbnailRenderer().BeginPersistentScene();
+		bPersistentScenes = true;
+	}
+}
+
+void FThumbnailToTextureExporter::EndPersistentScenes()
+{
+	if (bPersistentScenes)
+	{
+		IThumbnailToTextureToolModule::GetCustomBlueprintThumbnailRenderer().EndPersistentScene();
+		IThumbnailToTextureToolModule::GetCustomStaticMeshThumbnailRenderer().EndPersistentScene();
+		bPersistentScenes = false;
+	}
+}
+
+bool FThumbnailToTextureExporter::DoesAssetSupportExportToThumbnail(const FAssetData& AssetData)
+{
+	// #TODO (NanceDevDiaries) add more support as it comes. Example, SkeletalMesh once it's figured
+	// The logic of its saved render data
+	const FName AssetName = AssetData.AssetClassPath.GetAssetName();
+	return AssetName == TEXT("StaticMesh")
+		|| AssetName == TEXT("Blueprint");
+}
+
+FThumbnailExportStats FThumbnailToTextureExporter::ExportAssets(const TArray<FAssetData>& Assets)
+{
+	FThumbnailExportStats Stats;
+	BeginExport(Assets.Num(), Stats);
+
+	for (const FAssetData& AssetData : Assets)
+	{
+		ExportAsset(AssetData, Stats);
+	}
+
+	FinishExport(Stats);
+	return Stats;
+}
+
+void FThumbnailToTextureExporter::BeginExport(int32 NumAssets, FThumbnailExportStats& OutStats)
+{
+	OutStats = FThumbnailExportStats();
+	OutStats.NumRequested = NumAssets;
+
+	// Consecutive batches swap their assets in the same preview scenes instead of emptying them after every render
+	BeginPersistentScenes();
+
+	ExportStartTime = FPlatformTime::Seconds();
+	StartPoolStats = IThumbnailToTextureToolModule::GetRenderTargetPool().GetStats();
+	StartDerivedDataCacheHits = NumDerivedDataCacheHits;
+	StartDerivedDataCacheMisses = NumDerivedDataCacheMisses;
+	StartNumShaderCompileDeferrals = NumShaderCompileDeferrals;
+	StartStreamingWaitSeconds = StreamingWaitSeconds;
+	StartNumStreamingTimeouts = NumStreamingTimeouts;
+}
+
+void FThumbnailToTextureExporter::ExportAsset(const FAssetData& AssetData, FThumbnailExportStats& InOutStats)
+{
+	if (!DoesAssetSupportExportToThumbnail(AssetData))
+	{
+		// Skip unsupported class
+		++InOutStats.NumUnsupported;
+		return;
+	}
+
+	switch (ExportAsset(AssetData))
+	{
+	case EThumbnailExportResult::Rendered:
+		++InOutStats.NumRendered;
+		++InOutStats.NumExported;
+		break;
+	case EThumbnailExportResult::Cached:
+	case EThumbnailExportResult::DerivedDataCache:
+		++InOutStats.NumExported;
+		break;
+	case EThumbnailExportResult::Skipped:
+		++InOutStats.NumSkipped;
+		break;
+	default:
+		++InOutStats.NumFailed;
+		InOutStats.FailedAssets.Add(AssetData.GetObjectPathString());
+		break;
+	}
+}
+
+void FThumbnailToTextureExporter::FinishExport(FThumbnailExportStats& InOutStats)
+{
+	SavePendingPackages(InOutStats);
+
+	// Everything is drawn, the scenes let go of the last batch's meshes and actors so they can be collected, deleted or reloaded
+	EndPersistentScenes();
+
+	const FThumbnailRenderTargetPoolStats& EndPoolStats = IThumbnailToTextureToolModule::GetRenderTargetPool().GetStats();
+	InOutStats.NumRenderTargetPoolHits = EndPoolStats.NumHits - StartPoolStats.NumHits;
+	InOutStats.NumRenderTargetPoolMisses = EndPoolStats.NumMisses - StartPoolStats.NumMisses;
+	InOutStats.NumDerivedDataCacheHits = NumDerivedDataCacheHits - StartDerivedDataCacheHits;
+	InOutStats.NumDerivedDataCacheMisses = NumDerivedDataCacheMisses - StartDerivedDataCacheMisses;
+	InOutStats.NumShaderCompileDeferrals = NumShaderCompileDeferrals - StartNumShaderCompileDeferrals;
+	InOutStats.StreamingWaitSeconds = StreamingWaitSeconds - StartStreamingWaitSeconds;
+	InOutStats.NumStreamingTimeouts = NumStreamingTimeouts - StartNumStreamingTimeouts;
+	InOutStats.WallTimeSeconds = FPlatformTime::Seconds() - ExportStartTime;
+	InOutStats.ExportTimeSeconds = InOutStats.WallTimeSeconds - InOutStats.TextureCompileWaitSeconds - InOutStats.SaveTimeSeconds;
+}
+
+void FThumbnailToTextureExporter::CancelPendingExports()
+{
+	// Wait for the GPU to be done with the render targets, the pixels are thrown away
+	FlushBatch();
+	if (ReadbackRing.IsValid())
+	{
+		TArray<FThumbnailReadback> Completed;
+		ReadbackRing->Flush(Completed);
+	}
+
+	TArray<UPackage*> PackagesToRestore;
+	for (TPair<int32, FPendingPackage>& InFlight : InFlightRenders)
+	{
+		DiscardTexture(InFlight.Value, PackagesToRestore);
+	}
+	for (FPendingPackage& Pending : PendingCachedPackages)
+	{
+		DiscardTexture(Pending, PackagesToRestore);
+	}
+	for (FPendingPackage& Pending : PendingPackages)
+	{
+		DiscardTexture(Pending, PackagesToRestore);
+	}
+	RestorePackages(PackagesToRestore);
+
+	// Their textures are in InFlightRenders
+	DeferredRenders.Reset();
+
+	// Image files can't be taken back once written, they are left out of the manifest so the next export writes them again
+	for (FPendingPackage& Pending : PendingImageWrites)
+	{
+		Pending.ImageWrite.Wait();
+	}
+	PendingImageWrites.Reset();
+	NumImageWritesWaited = 0;
+
+	// The appended thumbnails are left out of the container's index, written again by the writer's destructor
+	ContainerWriter.Reset();
+
+	InFlightRenders.Reset();
+	PendingCachedPackages.Reset();
+	PendingCachedReads.Reset();
+	PendingPackages.Reset();
+	FailedCachedAssets.Reset();
+
+	// Keeps what was saved before the cancel, the discarded assets were already removed
+	if (Manifest.IsValid())
+	{
+		Manifest->Save();
+	}
+
+	EndPersistentScenes();
+}
+
+void FThumbnailToTextureExporter::DiscardTexture(const FPendingPackage& Pending, TArray<UPackage*>& OutPackagesToRestore)
+{
+	// Image exports have nothing in memory
+	if (!Pending.Texture)
+	{
+		return;
+	}
+
+	// The texture of an existing package replaced the saved one in memory, the package stays dirty until it is loaded back
+	if (FPackageName::DoesPackageExist(Pending.Package->GetName()))
+	{
+		OutPackagesToRestore.AddUnique(Pending.Package);
+		return;
+	}
+
+	// Packages that were only created in memory for the export go away with the texture
+	Pending.Texture->ClearFlags(RF_Public | RF_Standalone);
+	Pending.Texture->MarkAsGarbage();
+	Pending.Package->SetDirtyFlag(false);
+	Pending.Package->ClearFlags(RF_Standalone);
+	Pending.Package->MarkAsGarbage();
+}
+
+void FThumbnailToTextureExporter::RestorePackages(const TArray<UPackage*>& Packages)
+{
+	if (Packages.Num() == 0)
+	{
+		return;
+	}
+
+	// One reload for all of them, it collects garbage
+	FText ErrorMessage;
+	if (!UPackageTools::ReloadPackages(Packages, ErrorMessage, UPackageTools::EReloadPackagesInteractionMode::AssumePositive))
+	{
+		// Still dirty, the editor offers to save or revert them
+		UE_LOG(LogThumbnailToTexture, Warning, TEXT("Couldn't load back the %d existing textures replaced by the discarded export, they are left with unsaved changes: %s"),
+			Packages.Num(), *ErrorMessage.ToString());
+	}
+}
+
+void FThumbnailToTextureExporter::EnableIncrementalExport(const FString& ManifestFilename)
+{
+	Manifest = MakeUnique<FThumbnailExportManifest>(ManifestFilename);
+	Manifest->Load();
+	UE_LOG(LogThumbnailToTexture, Display, TEXT("Incremental export, %d assets in the manifest %s"), Manifest->Num(), *ManifestFilename);
+}
+
+bool FThumbnailToTextureExporter::ShouldRenderThumbnails() const
+{
+	// Without a RHI (-nullrhi) nothing can be rendered, the thumbnail saved in the package is the only option
+	const bool bCanRender = FApp::CanEverRender() && !bForceCachedThumbnails;
+	// The cached thumbnail is a single view, turntables and impostors have to be rendered even over the default background
+	return bCanRender && (Settings->bUseTransparentBackground || Settings->bUseCustomBackgroundMaterial || TurntableLayout.IsTurntable() || ImpostorLayout.IsImpostor());
+}
+
+bool FThumbnailToTextureExporter::ShouldUseDerivedDataCache() const
+{
+	return bUseDerivedDataCache && Settings->bUseDerivedDataCache && ShouldRenderThumbnails();
+}
+
+bool FThumbnailToTextureExporter::GetTexturePackageName(const FAssetData& AssetData, FString& OutPackageName, FString& OutAssetName) const
+{
+	FString GamePath = AssetData.GetObjectPathString();
+	if (int32 PathEnd; GamePath.FindLastChar('/', PathEnd))
+	{
+		++PathEnd;
+		OutAssetName = GamePath;
+		OutAssetName.RightChopInline(PathEnd);
+		int32 extensionIdx;
+		if (OutAssetName.FindChar('.', extensionIdx))
+		{
+			OutAssetName.LeftInline(extensionIdx);
+		}
+		OutAssetName = Settings->ThumbnailPrefix + OutAssetName;
+	}
+	else
+	{
+		OutAssetName = "T_Thumbnail";
+	}
+
+	if (int32 PathSeparatorIdx; OutAssetName.FindChar('/', PathSeparatorIdx))
+	{
+		// TextureName should not have any path separators in it
+		return false;
+	}
+
+	OutPackageName = Settings->RootTexture2DSaveDir + OutAssetName;
+	return true;
+}
+
+FString FThumbnailToTextureExporter::GetImageFilename(const FAssetData& AssetData, const FString& AssetName) const
+{
+	// /Game/Props/SM_Chair is written to <ImageOutputDir>/Game/Props/<Prefix>SM_Chair.png
+	FString ContentFolder = AssetData.PackagePath.ToString();
+	ContentFolder.RemoveFromStart(TEXT("/"));
+	return FPaths::Combine(Settings->ImageOutputDir, ContentFolder, AssetName + ThumbnailImageWriter::GetExtension(Settings->OutputFormat));
+}
+
+EThumbnailExportResult FThumbnailToTextureExporter::ExportAsset(const FAssetData& AssetData)
+{
+	// developed from engine code and help from a mix of https://forums.unrealengine.com/t/copy-asset-thumbnail-to-new-texture2d/138054/4
+	// and https://isaratech.com/save-a-procedurally-generated-texture-as-a-new-asset/
+	// and https://arrowinmyknee.com/2020/08/28/asset-right-click-menu-in-ue4/
+	// and https://dev.epicgames.com/community/snippets/lw1/procedural-texture-with-c
+	// and https://forums.unrealengine.com/t/programatically-created-asset-fails-to-save-or-crashes-the-editor/724517
+	FString PackageName;
+	FString AssetName;
+	if (!GetTexturePackageName(AssetData, PackageName, AssetName))
+	{
+		return EThumbnailExportResult::Failed;
+	}
+
+	// Load the image from the asset's loaded Thumbnail
+	FString PackageFilename;
+	if (!FPackageName::DoesPackageExist(AssetData.PackageName.ToString(), &PackageFilename))
+	{
+		return EThumbnailExportResult::Failed;
+	}
+
+	const bool bRender = ShouldRenderThumbnails();
+	const FString SourceAssetPath = AssetData.GetObjectPathString();
+
+	// Empty when some input is only in memory, the export can then neither be skipped nor cached
+	FString InputHash;
+	if ((Manifest.IsValid() || ShouldUseDerivedDataCache()) && !InputHasher.ComputeInputHash(AssetData, bRender, *Settings, InputHash))
+	{
+		InputHash.Reset();
+	}
+
+	// Image files and the container are recorded in the manifest in place of the package
+	FString OutputName = PackageName;
+	if (Settings->OutputFormat == EThumbnailOutputFormat::Container)
+	{
+		OutputName = Settings->ContainerFilename;
+	}
+	else if (IsExportingImages())
+	{
+		OutputName = GetImageFilename(AssetData, AssetName);
+	}
+
+	if (Manifest.IsValid())
+	{
+		// A container started over since, after a crash or a corruption, no longer has the thumbnails its records point at
+		if (!InputHash.IsEmpty() && Manifest->IsUpToDate(SourceAssetPath, InputHash, OutputName)
+			&& (Settings->OutputFormat != EThumbnailOutputFormat::Container || GetContainerWriter().Contains(SourceAssetPath)))
+		{
+			return EThumbnailExportResult::Skipped;
+		}
+
+		// Not recorded until the texture is saved again
+		Manifest->Remove(SourceAssetPath);
+	}
+
+	FPendingPackage Pending;
+	Pending.SourceAssetPath = SourceAssetPath;
+	Pending.InputHash = MoveTemp(InputHash);
+
+	if (IsExportingImages())
+	{
+		// No package nor texture, the pixels go straight to the file
+		Pending.ImageFilename = OutputName;
+	}
+	else
+	{
+		// Create the new texture 2D and save it on disk
+		Pending.Package = CreatePackage(*PackageName);
+		Pending.Package->FullyLoad();
+
+		Pending.Texture = NewObject<UTexture2D>(Pending.Package, *AssetName, RF_Public | RF_Standalone);
+		Pending.Texture->MarkPackageDirty();
+	}
+
+	if (bRender)
+	{
+		if (ShouldUseDerivedDataCache() && !Pending.InputHash.IsEmpty())
+		{
+			Pending.DerivedDataKey = ThumbnailDerivedData::BuildKey(Pending.InputHash);
+			if (ExportDerivedDataThumbnail(Pending))
+			{
+				return EThumbnailExportResult::DerivedDataCache;
+			}
+		}
+
+		// TODO find out more why this might happen for skeletalMeshes
+		const int32 RequestId = NextRequestId++;
+		if (BeginRenderedThumbnail(AssetData, RequestId))
+		{
+			// The texture is filled once the pixels are back from the GPU
+			Pending.bRendered = true;
+			InFlightRenders.Add(RequestId, MoveTemp(Pending));
+			PollReadbacks(false);
+			return EThumbnailExportResult::Rendered;
+		}
+
+		// The cached thumbnail has other inputs than the rendered one
+		Pending.InputHash.Reset();
+		Pending.DerivedDataKey.Reset();
+	}
+
+	// use the existing thumbnail, read along with the ones of the next assets
+	PendingCachedPackages.Add(MoveTemp(Pending));
+	FCachedThumbnailRead& Read = PendingCachedReads.AddDefaulted_GetRef();
+	Read.PackageFilename = MoveTemp(PackageFilename);
+	Read.ObjectPathInPackage = AssetData.AssetName.ToString();
+
+	if (PendingCachedReads.Num() >= ThumbnailToTextureExporter::MaxCachedReadsPerFlush)
+	{
+		FlushCachedThumbnails();
+	}
+	return EThumbnailExportResult::Cached;
+}
+
+bool FThumbnailToTextureExporter::BeginRenderedThumbnail(const FAssetData& AssetData, int32 RequestId)
+{
+	UObject* Object = nullptr;
+	{
+		THUMBNAILTOTEXTURE_SCOPE(LoadAsset);
+		Object = AssetData.GetAsset();
+	}
+	THUMBNAILTOTEXTURE_COUNT(LoadAsset, 1);
+
+	if (Object && !IsValidChecked(Object))
+	{
+		Object = nullptr;
+	}
+
+	// Get the rendering info for this object
+	FThumbnailRenderingInfo* RenderInfo = GUnrealEd && Object
+		                                      ? GUnrealEd->GetThumbnailManager()->GetRenderingInfo(Object)
+		                                      : nullptr;
+	if (!RenderInfo || !RenderInfo->Renderer)
+	{
+		return false;
+	}
+
+	if (!ReadbackRing.IsValid())
+	{
+		const int32 NumReadbacksInFlight = FMath::Max(1, Settings->NumReadbacksInFlight);
+
+		// Thumbnails are rendered bigger and filtered down when supersampling
+		SupersampleFactor = FMath::Clamp(Settings->SupersampleFactor, 1, 4);
+		int32 FrameSize = FMath::Max(1, Settings->ThumbnailResolution);
+
+		// Frames of a turntable sheet, or views of every layer of an impostor
+		const FIntPoint FrameGrid = ImpostorLayout.IsImpostor() ? ImpostorLayout.GetRenderSize(FIntPoint(1)) : TurntableLayout.GetSheetSize(FIntPoint(1));
+
+		// They must fit in one render target, supersampling is dropped first then the frames get smaller
+		const int32 MaxDimension = static_cast<int32>(GetMax2DTextureDimension());
+		const int32 MaxFramesPerRow = FMath::Max(FrameGrid.X, FrameGrid.Y);
+		while (SupersampleFactor > 1 && FrameSize * SupersampleFactor * MaxFramesPerRow > MaxDimension)
+		{
+			--SupersampleFactor;
+		}
+		if (FrameSize * SupersampleFactor * MaxFramesPerRow > MaxDimension)
+		{
+			FrameSize = FMath::Max(1, MaxDimension / (SupersampleFactor * MaxFramesPerRow));
+			UE_LOG(LogThumbnailToTexture, Warning, TEXT("%d x %d frames of %d pixels don't fit in a %d texture, the frames are exported at %d pixels"),
+				FrameGrid.X, FrameGrid.Y, Settings->ThumbnailResolution, MaxDimension, FrameSize);
+		}
+		TileSize = FrameGrid * (FrameSize * SupersampleFactor);
+
+		// The tiles of a batch must fit in one render target
+		const int32 MaxTilesPerRow = FMath::Max(1, MaxDimension / FMath::Max(TileSize.X, TileSize.Y));
+		BatchSize = FMath::Clamp(Settings->MaxBatchSize, 1, MaxTilesPerRow * MaxTilesPerRow);
+
+		// Tiles are laid out on a grid as square as possible
+		const int32 NumColumns = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(BatchSize)));
+		const int32 NumRows = FMath::DivideAndRoundUp(BatchSize, NumColumns);
+		ReadbackRing = MakeUnique<FThumbnailReadbackRing>(NumReadbacksInFlight, FIntPoint(TileSize.X * NumColumns, TileSize.Y * NumRows));
+	}
+
+	EBatchRenderer BatchRenderer = EBatchRenderer::Other;
+	if (RenderInfo->Renderer->IsA(UBlueprintThumbnailRenderer::StaticClass()))
+	{
+		BatchRenderer = EBatchRenderer::Blueprint;
+	}
+	else if (RenderInfo->Renderer->IsA(UStaticMeshThumbnailRenderer::StaticClass()))
+	{
+		BatchRenderer = EBatchRenderer::StaticMesh;
+	}
+
+	// Only the preview scenes of the static meshes and blueprints can be looked at from any direction
+	if (ImpostorLayout.IsImpostor() && BatchRenderer != EBatchRenderer::StaticMesh && BatchRenderer != EBatchRenderer::Blueprint)
+	{
+		UE_LOG(LogThumbnailToTexture, Warning, TEXT("%s has no impostor renderer, its cached thumbnail is exported instead"), *AssetData.GetObjectPathString());
+		return false;
+	}
+
+	UThumbnailRenderer* OtherRenderer = BatchRenderer == EBatchRenderer::Other ? RenderInfo->Renderer : nullptr;
+
+	// Drawing now would show the default material, the assets after this one are drawn while its shaders compile
+	TArray<UMaterialInterface*> Materials;
+	ThumbnailToTextureExporter::GatherUsedMaterials(Object, Materials);
+
+	TArray<TWeakObjectPtr<UMaterialInterface>> CompilingMaterials;
+	for (UMaterialInterface* Material : Materials)
+	{
+		if (ThumbnailToTextureExporter::IsShaderMapCompiling(Material))
+		{
+			// Moves the remaining jobs of the shader map ahead of the background compilation
+			Material->GetMaterialResource(GMaxRHIFeatureLevel)->SubmitCompileJobs_GameThread(EShaderCompileJobPriority::High);
+			CompilingMaterials.Add(Material);
+		}
+	}
+
+	if (CompilingMaterials.Num() > 0)
+	{
+		++NumShaderCompileDeferrals;
+		DeferredRenders.Add({TStrongObjectPtr<UObject>(Object), RequestId, BatchRenderer, OtherRenderer, MoveTemp(CompilingMaterials)});
+		UE_LOG(LogThumbnailToTexture, Verbose, TEXT("Deferring the render of %s until the shaders of its materials are compiled"), *Object->GetPathName());
+		return true;
+	}
+
+	QueueBatchItem(Object, RequestId, BatchRenderer, OtherRenderer);
+	return true;
+}
+
+void FThumbnailToTextureExporter::QueueBatchItem(UObject* Object, int32 RequestId, EBatchRenderer BatchRenderer, UThumbnailRenderer* OtherRenderer)
+{
+	// A batch is drawn by a single renderer
+	if (BatchRenderer != PendingBatchRenderer || BatchRenderer == EBatchRenderer::Other)
+	{
+		FlushBatch();
+	}
+
+	PendingBatch.Add({Object, RequestId});
+	PendingBatchRenderer = BatchRenderer;
+	PendingBatchOtherRenderer = OtherRenderer;
+
+	// Engine renderers only draw one asset at a time
+	if (BatchRenderer == EBatchRenderer::Other || PendingBatch.Num() >= BatchSize)
+	{
+		FlushBatch();
+	}
+}
+
+void FThumbnailToTextureExporter::UpdateDeferredRenders()
+{
+	if (DeferredRenders.Num() == 0)
+	{
+		return;
+	}
+
+	// Commandlets don't tick the engine, the compiled shader maps are only applied here
+	if (GShaderCompilingManager)
+	{
+		constexpr bool bLimitExecutionTime = true;
+		constexpr bool bBlockOnGlobalShaderCompletion = false;
+		GShaderCompilingManager->ProcessAsyncResults(bLimitExecutionTime, bBlockOnGlobalShaderCompletion);
+	}
+
+	for (int32 Index = 0; Index < DeferredRenders.Num();)
+	{
+		FDeferredRender& Deferred = DeferredRenders[Index];
+		const bool bStillCompiling = Deferred.CompilingMaterials.ContainsByPredicate([](const TWeakObjectPtr<UMaterialInterface>& Material)
+		{
+			return ThumbnailToTextureExporter::IsShaderMapCompiling(Material.Get());
+		});
+
+		if (bStillCompiling)
+		{
+			++Index;
+			continue;
+		}
+
+		QueueBatchItem(Deferred.Object.Get(), Deferred.RequestId, Deferred.BatchRenderer, Deferred.OtherRenderer);
+		DeferredRenders.RemoveAt(Index);
+	}
+}
+
+void FThumbnailToTextureExporter::FinishDeferredRenders()
+{
+	UpdateDeferredRenders();
+	if (DeferredRenders.Num() == 0)
+	{
+		return;
+	}
+
+	// Nothing else is left to draw while the shaders compile
+	if (GShaderCompilingManager)
+	{
+		GShaderCompilingManager->FinishAllCompilation();
+	}
+
+	// Drawn even if a shader failed to compile, like the engine's own thumbnails
+	for (FDeferredRender& Deferred : DeferredRenders)
+	{
+		QueueBatchItem(Deferred.Object.Get(), Deferred.RequestId, Deferred.BatchRenderer, Deferred.OtherRenderer);
+	}
+	DeferredRenders.Reset();
+}
+
+void FThumbnailToTextureExporter::FlushBatch()
+{
+	if (PendingBatch.Num() == 0)
+	{
+		return;
+	}
+
+	check(ReadbackRing.IsValid());
+	const int32 NumColumns = ReadbackRing->GetSize().X / TileSize.X;
+	check(PendingBatch.Num() <= BatchSize);
+
+	TArray<UObject*> Objects;
+	TArray<FIntRect> Tiles;
+	TArray<FThumbnailReadbackTile> ReadbackTiles;
+	for (int32 TileIndex = 0; TileIndex < PendingBatch.Num(); ++TileIndex)
+	{
+		const FIntPoint TileMin((TileIndex % NumColumns) * TileSize.X, (TileIndex / NumColumns) * TileSize.Y);
+		const FIntRect Tile(TileMin, TileMin + TileSize);
+
+		Objects.Add(PendingBatch[TileIndex].Object);
+		Tiles.Add(Tile);
+		ReadbackTiles.Add({PendingBatch[TileIndex].RequestId, Tile});
+	}
+
+	// Waits for the oldest render if every render target is in flight
+	TArray<FThumbnailReadback> Completed;
+	FTextureRenderTargetResource* RenderTargetResource = ReadbackRing->BeginRender(Completed);
+	ProcessCompletedReadbacks(Completed);
+
+	THUMBNAILTOTEXTURE_SCOPE(Render);
+	THUMBNAILTOTEXTURE_COUNT(Render, PendingBatch.Num());
+
+	// Create a canvas for the render target and clear it to black
+	FCanvas Canvas(RenderTargetResource, nullptr, FGameTime::GetTimeSinceAppStart(), GMaxRHIFeatureLevel);
+	Canvas.Clear(FLinearColor::Black);
+
+	constexpr bool bAdditionalViewFamily = false;
+
+	// Engine renderers don't wait, their Content Browser thumbnails are redrawn as the mips stream in
+	FThumbnailStreamingWaitResult StreamingWait;
+	switch (PendingBatchRenderer)
+	{
+	case EBatchRenderer::Blueprint:
+		// Draw the thumbnails
+		StreamingWait = IThumbnailToTextureToolModule::GetCustomBlueprintThumbnailRenderer().DrawBatch(Objects, Tiles,
+			RenderTargetResource, &Canvas, bAdditionalViewFamily, *Settings);
+		break;
+	case EBatchRenderer::StaticMesh:
+		StreamingWait = IThumbnailToTextureToolModule::GetCustomStaticMeshThumbnailRenderer().DrawBatch(Objects, Tiles,
+			RenderTargetResource, &Canvas, bAdditionalViewFamily, *Settings);
+		break;
+	default:
+		check(PendingBatch.Num() == 1 && PendingBatchOtherRenderer);
+		// Engine renderers have a fixed camera, every frame of a turntable gets the same view
+		for (int32 FrameIndex = 0; FrameIndex < TurntableLayout.NumFrames; ++FrameIndex)
+		{
+			const FIntRect Frame = TurntableLayout.GetFrameRect(Tiles[0], FrameIndex);
+			PendingBatchOtherRenderer->Draw(Objects[0], Frame.Min.X, Frame.Min.Y, Frame.Width(), Frame.Height(),
+				RenderTargetResource, &Canvas, bAdditionalViewFamily);
+		}
+		break;
+	}
+
+	// Tell the rendering thread to draw any remaining batched elements
+	Canvas.Flush_GameThread();
+
+	// Every asset of the batch waited for the same fence
+	StreamingWaitSeconds += StreamingWait.WaitSeconds;
+	for (const FBatchItem& Item : PendingBatch)
+	{
+		if (StreamingWait.bTimedOut)
+		{
+			++NumStreamingTimeouts;
+			UE_LOG(LogThumbnailToTexture, Warning, TEXT("Rendered %s after waiting %.2fs with %d of the %d textures and meshes of its batch still streaming in, the thumbnail may be blurry"),
+				*GetPathNameSafe(Item.Object), StreamingWait.WaitSeconds, StreamingWait.NumPendingAssets, StreamingWait.NumAssets);
+		}
+		else if (StreamingWait.WaitSeconds > 0.0)
+		{
+			UE_LOG(LogThumbnailToTexture, Verbose, TEXT("Waited %.3fs for %d textures and meshes to stream in before rendering %s"),
+				StreamingWait.WaitSeconds, StreamingWait.NumAssets, *GetPathNameSafe(Item.Object));
+		}
+	}
+
+	// The pixels are copied back while the next assets are drawn, see ProcessCompletedReadbacks()
+	ReadbackRing->EndRender(ReadbackTiles);
+
+	PendingBatch.Reset();
+	PendingBatchRenderer = EBatchRenderer::None;
+	PendingBatchOtherRenderer = nullptr;
+}
+
+void FThumbnailToTextureExporter::PollReadbacks(bool bWaitForAll)
+{
+	if (bWaitForAll)
+	{
+		FinishDeferredRenders();
+		FlushBatch();
+	}
+	else
+	{
+		UpdateDeferredRenders();
+	}
+
+	if (!ReadbackRing.IsValid())
+	{
+		return;
+	}
+
+	TArray<FThumbnailReadback> Completed;
+	if (bWaitForAll)
+	{
+		ReadbackRing->Flush(Completed);
+	}
+	else
+	{
+		ReadbackRing->PollCompleted(Completed);
+	}
+	ProcessCompletedReadbacks(Completed);
+}
+
+void FThumbnailToTextureExporter::ProcessCompletedReadbacks(TArray<FThumbnailReadback>& Completed)
+{
+	THUMBNAILTOTEXTURE_COUNT(Readback, Completed.Num());
+
+	for (FThumbnailReadback& Readback : Completed)
+	{
+		FPendingPackage Pending;
+		if (ensure(InFlightRenders.RemoveAndCopyValue(Readback.RequestId, Pending)))
+		{
+			if (Pending.Texture)
+			{
+				FinishRenderedThumbnail(Readback, Pending.Texture, Pending.DerivedDataKey);
+				PendingPackages.Add(MoveTemp(Pending));
+			}
+			else
+			{
+				FinishRenderedImage(Readback, MoveTemp(Pending));
+			}
+		}
+	}
+}
+
+bool FThumbnailToTextureExporter::ExportDerivedDataThumbnail(FPendingPackage& Pending)
+{
+	FIntPoint Size;
+	TArray<FColor> Pixels;
+	{
+		THUMBNAILTOTEXTURE_SCOPE(DerivedData);
+		if (!ThumbnailDerivedData::Get(Pending.DerivedDataKey, Pending.SourceAssetPath, Size, Pixels))
+		{
+			++NumDerivedDataCacheMisses;
+			return false;
+		}
+	}
+
+	++NumDerivedDataCacheHits;
+	THUMBNAILTOTEXTURE_COUNT(DerivedData, 1);
+
+	if (!Pending.Texture)
+	{
+		WriteImage(MoveTemp(Pending), Size, MoveTemp(Pixels));
+		return true;
+	}
+
+	Pending.Texture->Source.Init(Size.X, Size.Y, 1, 1, TSF_BGRA8, reinterpret_cast<const uint8*>(Pixels.GetData()));
+	ApplyRenderedTextureSettings(Pending.Texture);
+	PendingPackages.Add(MoveTemp(Pending));
+	return true;
+}
+
+FIntPoint FThumbnailToTextureExporter::GetExportedSize(const FThumbnailReadback& Readback) const
+{
+	const FIntPoint FilteredSize = FIntPoint(Readback.Width, Readback.Height) / SupersampleFactor;
+	return ImpostorLayout.IsImpostor() ? ImpostorLayout.GetAtlasSize(FilteredSize) : FilteredSize;
+}
+
+void FThumbnailToTextureExporter::KeyRenderedPixels(const FThumbnailReadback& Readback, FColor* OutPixels) const
+{
+	const FIntPoint RenderSize(Readback.Width, Readback.Height);
+
+	// Keying is done at the render resolution, within the filter, so the cut out edges are smoothed
+	{
+		THUMBNAILTOTEXTURE_SCOPE(Keying);
+		if (ImpostorLayout.IsImpostor())
+		{
+			ImpostorLayout.BuildAtlas(Readback.Pixels, RenderSize, SupersampleFactor, Settings->BackgroundMode, Settings->KeyingParams, OutPixels);
+		}
+		else
+		{
+			ThumbnailImageUtils::KeyAndDownsample(Settings->BackgroundMode, Settings->KeyingParams, Readback.Pixels, RenderSize, SupersampleFactor, OutPixels);
+		}
+	}
+	THUMBNAILTOTEXTURE_COUNT(Keying, 1);
+}
+
+void FThumbnailToTextureExporter::FinishRenderedThumbnail(FThumbnailReadback& Readback, UTexture2D* NewTexture, const FString& DerivedDataKey)
+{
+	const FIntPoint Size = GetExportedSize(Readback);
+
+	// The read back rows are already top first, like the texture source. No platform data is filled here,
+	// ApplyRenderedTextureSettings() builds it from the source.
+	NewTexture->Source.Init(Size.X, Size.Y, 1, 1, TSF_BGRA8);
+	FColor* SourcePixels = reinterpret_cast<FColor*>(NewTexture->Source.LockMip(0));
+	KeyRenderedPixels(Readback, SourcePixels);
+
+	// Other machines and later runs fetch the final pixels instead of rendering them again
+	if (!DerivedDataKey.IsEmpty())
+	{
+		THUMBNAILTOTEXTURE_SCOPE(DerivedData);
+		ThumbnailDerivedData::Put(DerivedDataKey, NewTexture->GetPathName(), Size, SourcePixels);
+	}
+
+	NewTexture->Source.UnlockMip(0);
+	Readback.Pixels.Empty();
+
+	ApplyRenderedTextureSettings(NewTexture);
+}
+
+void FThumbnailToTextureExporter::FinishRenderedImage(FThumbnailReadback& Readback, FPendingPackage&& Pending)
+{
+	const FIntPoint Size = GetExportedSize(Readback);
+	TArray<FColor> Pixels;
+	Pixels.SetNumUninitialized(Size.X * Size.Y);
+	KeyRenderedPixels(Readback, Pixels.GetData());
+	Readback.Pixels.Empty();
+
+	if (!Pending.DerivedDataKey.IsEmpty())
+	{
+		THUMBNAILTOTEXTURE_SCOPE(DerivedData);
+		ThumbnailDerivedData::Put(Pending.DerivedDataKey, Pending.SourceAssetPath, Size, Pixels.GetData());
+	}
+
+	WriteImage(MoveTemp(Pending), Size, MoveTemp(Pixels));
+}
+
+void FThumbnailToTextureExporter::WriteImage(FPendingPackage&& Pending, FIntPoint Size, TArray<FColor>&& Pixels)
+{
+	if (Settings->OutputFormat == EThumbnailOutputFormat::Container)
+	{
+		Pending.ImageWrite = GetContainerWriter().Add(Pending.SourceAssetPath, Size, MoveTemp(Pixels));
+	}
+	else
+	{
+		Pending.ImageWrite = ThumbnailImageWriter::Launch(Settings->OutputFormat, Size, MoveTemp(Pixels), Pending.ImageFilename);
+	}
+	PendingImageWrites.Add(MoveTemp(Pending));
+
+	// The workers fell behind, the oldest write is usually done first
+	while (PendingImageWrites.Num() - NumImageWritesWaited > ThumbnailToTextureExporter::MaxImageWritesInFlight)
+	{
+		PendingImageWrites[NumImageWritesWaited++].ImageWrite.Wait();
+	}
+}
+
+FThumbnailContainerWriter& FThumbnailToTextureExporter::GetContainerWriter()
+{
+	if (!ContainerWriter.IsValid())
+	{
+		ContainerWriter = MakeUnique<FThumbnailContainerWriter>(Settings->ContainerFilename, Settings->ContainerEntryFormat);
+		ContainerWriter->Open();
+	}
+	return *ContainerWriter;
+}
+
+void FThumbnailToTextureExporter::ApplyRenderedTextureSettings(UTexture2D* NewTexture) const
+{
+	THUMBNAILTOTEXTURE_SCOPE(TextureBuild);
+	THUMBNAILTOTEXTURE_COUNT(TextureBuild, 1);
+
+	// Side tables of the sprite sheet or the impostor atlas, saved with the texture package
+	TurntableLayout.WriteToTexture(NewTexture);
+	ImpostorLayout.WriteToTexture(NewTexture);
+
+	NewTexture->SRGB = false;
+	// Mips built from the filtered pixels are kept as they are by the texture build
+	// Only a transparent background leaves an alpha that is coverage, the normal and depth layers of an impostor are never keyed
+	const bool bAlphaWeightedMips = Settings->BackgroundMode == EThumbnailBackgroundMode::Transparent && !ImpostorLayout.IsImpostor();
+	NewTexture->MipGenSettings = BuildSourceMips(NewTexture, bAlphaWeightedMips) ? TMGS_LeaveExistingMips : TMGS_FromTextureGroup;
+	NewTexture->LODGroup = TEXTUREGROUP_UI; // Prepare the asset for UI use
+	NewTexture->CompressionSettings = TC_EditorIcon; // UI setting
+
+	// Compressed now by the texture compiling manager while the next thumbnails are exported, rather than when saving.
+	// PostEditChange() isn't needed on a new texture, it would look through every material for users of the texture.
+	NewTexture->DeferCompression = false;
+	NewTexture->UpdateResource();
+}
+
+bool FThumbnailToTextureExporter::BuildSourceMips(UTexture2D* NewTexture, bool bAlphaWeighted) const
+{
+	const FIntPoint Size(NewTexture->Source.GetSizeX(), NewTexture->Source.GetSizeY());
+	const int32 NumMips = ThumbnailImageUtils::GetNumMips(Size);
+	if (!Settings->bGenerateMipsOnCPU || NumMips <= 1 || NewTexture->Source.GetFormat() != TSF_BGRA8)
+	{
+		return false;
+	}
+
+	THUMBNAILTOTEXTURE_SCOPE(MipGeneration);
+	THUMBNAILTOTEXTURE_COUNT(MipGeneration, 1);
+
+	// Mip 0 starts the chain, the smaller mips are written after it
+	TArray64<uint8> Chain;
+	if (!NewTexture->Source.GetMipData(Chain, 0))
+	{
+		return false;
+	}
+
+	const int64 NumChainPixels = ThumbnailImageUtils::GetMipChainNumPixels(Size, NumMips);
+	Chain.SetNumUninitialized(NumChainPixels * sizeof(FColor));
+	ThumbnailImageUtils::BuildMipChain(MakeArrayView(reinterpret_cast<FColor*>(Chain.GetData()), static_cast<int32>(NumChainPixels)), Size, NumMips, bAlphaWeighted);
+
+	NewTexture->Source.Init(Size.X, Size.Y, 1, NumMips, TSF_BGRA8, Chain.GetData());
+	return true;
+}
+
+void FThumbnailToTextureExporter::FinishTextureCompilation(FThumbnailExportStats& OutStats)
+{
+	TArray<UTexture*> CompilingTextures;
+	for (const FPendingPackage& Pending : PendingPackages)
+	{
+		if (Pending.Texture->IsCompiling())
+		{
+			CompilingTextures.Add(Pending.Texture);
+		}
+	}
+
+	OutStats.NumTexturesCompiledInBackground += PendingPackages.Num() - CompilingTextures.Num();
+	OutStats.NumTexturesCompiledAtEnd += CompilingTextures.Num();
+
+	if (CompilingTextures.Num() > 0)
+	{
+		THUMBNAILTOTEXTURE_SCOPE(TextureCompileWait);
+		THUMBNAILTOTEXTURE_COUNT(TextureCompileWait, CompilingTextures.Num());
+
+		const double StartTime = FPlatformTime::Seconds();
+		FTextureCompilingManager::Get().FinishCompilation(CompilingTextures);
+		OutStats.TextureCompileWaitSeconds += FPlatformTime::Seconds() - StartTime;
+	}
+}
+
+void FThumbnailToTextureExporter::FlushCachedThumbnails()
+{
+	if (PendingCachedReads.Num() == 0)
+	{
+		return;
+	}
+
+	{
+		THUMBNAILTOTEXTURE_SCOPE(CachedRead);
+		ThumbnailBulkReader::ReadThumbnails(PendingCachedReads);
+	}
+	THUMBNAILTOTEXTURE_COUNT(CachedRead, PendingCachedReads.Num());
+
+	for (int32 Index = 0; Index < PendingCachedReads.Num(); ++Index)
+	{
+		FPendingPackage& Pending = PendingCachedPackages[Index];
+		if (!PendingCachedReads[Index].bFound)
+		{
+			// Don't leave an empty texture behind
+			TArray<UPackage*> PackagesToRestore;
+			DiscardTexture(Pending, PackagesToRestore);
+			RestorePackages(PackagesToRestore);
+			FailedCachedAssets.Add(MoveTemp(Pending.SourceAssetPath));
+			continue;
+		}
+
+		if (!Pending.Texture)
+		{
+			WriteCachedThumbnailImage(PendingCachedReads[Index].Thumbnail, MoveTemp(Pending));
+			continue;
+		}
+
+		FillCachedThumbnailTexture(PendingCachedReads[Index].Thumbnail, Pending.Texture);
+		PendingPackages.Add(MoveTemp(Pending));
+	}
+
+	PendingCachedPackages.Reset();
+	PendingCachedReads.Reset();
+}
+
+void FThumbnailToTextureExporter::FillCachedThumbnailTexture(const FObjectThumbnail& Thumbnail, UTexture2D* NewTexture) const
+{
+	THUMBNAILTOTEXTURE_SCOPE(TextureBuild);
+	THUMBNAILTOTEXTURE_COUNT(TextureBuild, 1);
+
+	int32 SizeX = Thumbnail.GetImageWidth();
+	int32 SizeY = Thumbnail.GetImageHeight();
+
+	// Copied once, straight into the texture source. The platform data is built from it by UpdateResource()
+	NewTexture->Source.Init(SizeX, SizeY, 1, 1, TSF_BGRA8, Thumbnail.GetUncompressedImageData().GetData());
+	// The alpha of a cached thumbnail isn't coverage, it may be 0 everywhere
+	const bool bHasMips = BuildSourceMips(NewTexture, false);
+	NewTexture->MipGenSettings = bHasMips ? TMGS_LeaveExistingMips : TMGS_NoMipmaps;
+	NewTexture->LODGroup = TEXTUREGROUP_UI; // Prepare the asset for UI use
+	NewTexture->CompressionSettings = TC_Default;
+	// No need for "UserInterface2D", no need for alpha, it was also having issues making the asset have a thumbnail itself
+	// Without mips there is nothing to stream
+	NewTexture->NeverStream = !bHasMips;
+	NewTexture->CompressionNoAlpha = true;
+
+	// A cached thumbnail is a single frame, even if the texture was a turntable or an impostor before
+	FThumbnailTurntableLayout().WriteToTexture(NewTexture);
+	FThumbnailImpostorLayout().WriteToTexture(NewTexture);
+
+	NewTexture->UpdateResource();
+}
+
+void FThumbnailToTextureExporter::WriteCachedThumbnailImage(const FObjectThumbnail& Thumbnail, FPendingPackage&& Pending)
+{
+	// Cached thumbnails are BGRA8 like the rendered pixels
+	const FIntPoint Size(Thumbnail.GetImageWidth(), Thumbnail.GetImageHeight());
+	const TArray<uint8>& ImageData = Thumbnail.GetUncompressedImageData();
+	TArray<FColor> Pixels;
+	Pixels.SetNumZeroed(Size.X * Size.Y);
+	FMemory::Memcpy(Pixels.GetData(), ImageData.GetData(), FMath::Min<int64>(ImageData.Num(), Pixels.Num() * sizeof(FColor)));
+
+	// The alpha of a cached thumbnail isn't coverage and is often 0, the image would come out invisible
+	for (FColor& Pixel : Pixels)
+	{
+		Pixel.A = 255;
+	}
+
+	WriteImage(MoveTemp(Pending), Size, MoveTemp(Pixels));
+}
+
+void FThumbnailToTextureExporter::FinishImageWrites(FThumbnailExportStats& OutStats)
+{
+	if (PendingImageWrites.Num() == 0)
+	{
+		// Only opened to look up skipped assets, the index is already written
+		ContainerWriter.Reset();
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// The thumbnails can't be found in the container without its index. The writer is closed so the file can be read and
+	// written by other exports until the next one opens it again
+	const bool bContainerCommitted = !ContainerWriter.IsValid() || ContainerWriter->Commit();
+	ContainerWriter.Reset();
+
+	for (FPendingPackage& Pending : PendingImageWrites)
+	{
+		if (Pending.ImageWrite.GetResult() && bContainerCommitted)
+		{
+			THUMBNAILTOTEXTURE_COUNT(ImageWrite, 1);
+
+			if (Manifest.IsValid() && !Pending.InputHash.IsEmpty())
+			{
+				Manifest->Record(Pending.SourceAssetPath, Pending.InputHash, Pending.ImageFilename);
+			}
+		}
+		else
+		{
+			UE_LOG(LogThumbnailToTexture, Warning, TEXT("Failed to write %s"), *Pending.ImageFilename);
+			--OutStats.NumExported;
+			OutStats.NumRendered -= Pending.bRendered ? 1 : 0;
+			++OutStats.NumFailed;
+			OutStats.FailedAssets.Add(Pending.SourceAssetPath);
+		}
+	}
+
+	PendingImageWrites.Reset();
+	NumImageWritesWaited = 0;
+	OutStats.SaveTimeSeconds += FPlatformTime::Seconds() - StartTime;
+}
+
+void FThumbnailToTextureExporter::SavePendingPackages(FThumbnailExportStats& OutStats)
+{
+	// Renders and reads still in flight belong to this batch
+	PollReadbacks(true);
+	FlushCachedThumbnails();
+
+	for (FString& FailedAsset : FailedCachedAssets)
+	{
+		--OutStats.NumExported;
+		++OutStats.NumFailed;
+		OutStats.FailedAssets.Add(MoveTemp(FailedAsset));
+	}
+	FailedCachedAssets.Reset();
+
+	// The image files were encoded while the next assets were exported, only the last ones are waited for
+	FinishImageWrites(OutStats);
+
+	if (PendingPackages.Num() == 0)
+	{
+		// Failed assets may have been removed from the manifest
+		if (Manifest.IsValid())
+		{
+			Manifest->Save();
+		}
+		return;
+	}
+
+	// Saving needs the compiled platform data, wait once for all the textures instead of compiling each in turn
+	FinishTextureCompilation(OutStats);
+
+	THUMBNAILTOTEXTURE_SCOPE(Save);
+	const double StartTime = FPlatformTime::Seconds();
+
+	TArray<UPackage*> Packages;
+	TArray<FString> Filenames;
+	TArray<FString> NewFilenames;
+	Packages.Reserve(PendingPackages.Num());
+	Filenames.Reserve(PendingPackages.Num());
+	for (const FPendingPackage& Pending : PendingPackages)
+	{
+		Pending.Package->SetDirtyFlag(true);
+		Packages.Add(Pending.Package);
+
+		FString Filename = FPackageName::LongPackageNameToFilename(Pending.Package->GetName(), FPackageName::GetAssetPackageExtension());
+		if (!IFileManager::Get().FileExists(*Filename))
+		{
+			NewFilenames.Add(Filename);
+		}
+		Filenames.Add(MoveTemp(Filename));
+	}
+
+	// One source control round trip for the whole batch instead of one per package
+	ISourceControlModule& SourceControlModule = ISourceControlModule::Get();
+	if (SourceControlModule.IsEnabled() && SourceControlModule.GetProvider().IsAvailable())
+	{
+		constexpr bool bErrorIfAlreadyCheckedOut = false;
+		FEditorFileUtils::CheckoutPackages(Packages, nullptr, bErrorIfAlreadyCheckedOut);
+	}
+
+	TArray<FPackageSaveInfo> SaveInfos;
+	TArray<int32> SaveInfoToPending;
+	SaveInfos.Reserve(PendingPackages.Num());
+	for (int32 Index = 0; Index < PendingPackages.Num(); ++Index)
+	{
+		if (IFileManager::Get().IsReadOnly(*Filenames[Index]))
+		{
+			UE_LOG(LogThumbnailToTexture, Warning, TEXT("%s is read only, it couldn't be checked out"), *Filenames[Index]);
+			--OutStats.NumExported;
+			OutStats.NumRendered -= PendingPackages[Index].bRendered ? 1 : 0;
+			++OutStats.NumFailed;
+			OutStats.FailedAssets.Add(PendingPackages[Index].SourceAssetPath);
+			continue;
+		}
+
+		FPackageSaveInfo& SaveInfo = SaveInfos.AddDefaulted_GetRef();
+		SaveInfo.Package = PendingPackages[Index].Package;
+		SaveInfo.Asset = PendingPackages[Index].Texture;
+		SaveInfo.Filename = Filenames[Index];
+		SaveInfoToPending.Add(Index);
+	}
+
+	// Serialize the packages in parallel and let the file writes complete asynchronously
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+	SaveArgs.SaveFlags = SAVE_NoError | SAVE_Async;
+	SaveArgs.Error = GWarn;
+	TArray<FSavePackageResultStruct> Results;
+	UPackage::SaveConcurrent(SaveInfos, SaveArgs, Results);
+	UPackage::WaitForAsyncFileWrites();
+
+	for (int32 SaveIndex = 0; SaveIndex < SaveInfos.Num(); ++SaveIndex)
+	{
+		const FPendingPackage& Pending = PendingPackages[SaveInfoToPending[SaveIndex]];
+		if (Results.IsValidIndex(SaveIndex) && Results[SaveIndex].IsSuccessful())
+		{
+			FAssetRegistryModule::AssetCreated(Pending.Texture);
+			THUMBNAILTOTEXTURE_COUNT(Save, 1);
+
+			if (Manifest.IsValid() && !Pending.InputHash.IsEmpty())
+			{
+				Manifest->Record(Pending.SourceAssetPath, Pending.InputHash, Pending.Package->GetName());
+			}
+		}
+		else
+		{
+			UE_LOG(LogThumbnailToTexture, Warning, TEXT("Failed to save %s"), *SaveInfos[SaveIndex].Filename);
+			--OutStats.NumExported;
+			OutStats.NumRendered -= Pending.bRendered ? 1 : 0;
+			++OutStats.NumFailed;
+			OutStats.FailedAssets.Add(Pending.SourceAssetPath);
+		}
+	}
+
+	if (NewFilenames.Num() > 0 && SourceControlModule.IsEnabled() && SourceControlModule.GetProvider().IsAvailable())
+	{
+		NewFilenames.RemoveAll([](const FString& Filename) { return !IFileManager::Get().FileExists(*Filename); });
+		USourceControlHelpers::MarkFilesForAdd(NewFilenames);
+	}
+
+	if (Manifest.IsValid())
+	{
+		Manifest->Save();
+	}
+
+	PendingPackages.Reset();
+	OutStats.SaveTimeSeconds += FPlatformTime::Seconds() - StartTime;
+}
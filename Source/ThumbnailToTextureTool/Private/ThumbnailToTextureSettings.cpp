@@ -2,13 +2,31 @@
 
 
 #include "ThumbnailToTextureSettings.h"
+#include "ObjectTools.h"
+#include "Materials/Material.h"
+#include "Misc/Paths.h"
 #include "UObject/ConstructorHelpers.h"
 
+namespace ThumbnailToTextureSettings
+{
+	/** @return Path made full, taken from the project directory when it's relative */
+	FString GetFullProjectPath(const FString& Path)
+	{
+		return FPaths::ConvertRelativePathToFull(FPaths::IsRelative(Path) ? FPaths::ProjectDir() / Path : Path);
+	}
+}
+
 UThumbnailToTextureSettings::UThumbnailToTextureSettings(const FObjectInitializer& ObjectInitializer): UseCustomBackgroundMaterial(false), UseTransparentBackground(false),
-                                                            BackgroundCutoffThreshold(.5f)
+                                                            BackgroundCutoffThreshold(.5f), ThumbnailResolution(ThumbnailTools::DefaultThumbnailSize),
+                                                            SupersampleFactor(1), TurntableFrames(0), ImpostorGridSize(0), ImpostorFullSphere(false), NumReadbacksInFlight(3),
+                                                            MaxPooledRenderTargets(8), PreviewSceneCacheObjectBudgetMB(256), MaxBatchSize(8), UseDerivedDataCache(true),
+                                                            ExportFrameBudgetMs(20.f), StreamingWaitTimeoutSeconds(10.f), GenerateMipsOnCPU(false),
+                                                            OutputFormat(EThumbnailOutputFormat::Texture2D), ContainerEntryFormat(EThumbnailContainerEntryFormat::PNG)
 {
 	RootTexture2DSaveDir.Path = TEXT("/Game/ProceduralTextures/");
 	ThumbnailPrefix = TEXT("T_");
+	ImageOutputDirectory.Path = TEXT("Saved/ThumbnailToTexture/Images");
+	ContainerFile.FilePath = TEXT("Saved/ThumbnailToTexture/Thumbnails.ttc");
 
 	if (!IsRunningCommandlet())
 	{
@@ -44,3 +62,68 @@ UMaterial* UThumbnailToTextureSettings::GetBackgroundMaterial() const
 		return Cast<UMaterial>(BackgroundMaterial.TryLoad());
 	}
 }
+
+void UThumbnailToTextureSettings::LoadTranslucentMaterial()
+{
+	if (!TranslucentMaterial)
+	{
+		TranslucentMaterial = LoadObject<UMaterial>(nullptr, TEXT("/ThumbnailToTextureTool/BackgroundMaterialNoShadow.BackgroundMaterialNoShadow"));
+	}
+}
+
+TSharedRef<const FThumbnailToTextureSettingsSnapshot> UThumbnailToTextureSettings::MakeSnapshot() const
+{
+	// Loading the background material can only be done on the game thread
+	check(IsInGameThread());
+
+	TSharedRef<FThumbnailToTextureSettingsSnapshot> NewSnapshot = MakeShared<FThumbnailToTextureSettingsSnapshot>();
+	NewSnapshot->RootTexture2DSaveDir = RootTexture2DSaveDir.Path;
+	if (!NewSnapshot->RootTexture2DSaveDir.EndsWith(TEXT("/")))
+	{
+		NewSnapshot->RootTexture2DSaveDir += TEXT("/");
+	}
+	NewSnapshot->ThumbnailPrefix = ThumbnailPrefix;
+	NewSnapshot->bUseCustomBackgroundMaterial = UseCustomBackgroundMaterial;
+	NewSnapshot->bUseTransparentBackground = UseTransparentBackground;
+	NewSnapshot->BackgroundMaterial.Reset(GetBackgroundMaterial());
+	NewSnapshot->BackgroundMaterialPath = BackgroundMaterial.ToString();
+	NewSnapshot->BackgroundCutoffThreshold = BackgroundCutoffThreshold;
+	NewSnapshot->ThumbnailResolution = ThumbnailResolution;
+	NewSnapshot->SupersampleFactor = SupersampleFactor;
+	// An impostor is a single sheet of views already
+	NewSnapshot->ImpostorGridSize = FMath::Max(0, ImpostorGridSize);
+	NewSnapshot->bImpostorFullSphere = ImpostorFullSphere;
+	NewSnapshot->NumTurntableFrames = NewSnapshot->ImpostorGridSize > 0 ? 1 : FMath::Max(1, TurntableFrames);
+	NewSnapshot->NumReadbacksInFlight = NumReadbacksInFlight;
+	NewSnapshot->MaxBatchSize = MaxBatchSize;
+	NewSnapshot->bUseDerivedDataCache = UseDerivedDataCache;
+	NewSnapshot->StreamingWaitTimeoutSeconds = StreamingWaitTimeoutSeconds;
+	NewSnapshot->bGenerateMipsOnCPU = GenerateMipsOnCPU;
+	NewSnapshot->OutputFormat = OutputFormat;
+	// The project directory is itself relative to the executable, a full path doesn't depend on the working directory of the writers
+	NewSnapshot->ImageOutputDir = ThumbnailToTextureSettings::GetFullProjectPath(ImageOutputDirectory.Path);
+	if (!NewSnapshot->ImageOutputDir.EndsWith(TEXT("/")))
+	{
+		NewSnapshot->ImageOutputDir += TEXT("/");
+	}
+	NewSnapshot->ContainerFilename = ThumbnailToTextureSettings::GetFullProjectPath(ContainerFile.FilePath);
+	NewSnapshot->ContainerEntryFormat = ContainerEntryFormat;
+
+	if (UseTransparentBackground)
+	{
+		FLinearColor TransparentColor = FLinearColor::White;
+		if (TranslucentMaterial)
+		{
+			TranslucentMaterial->GetVectorParameterValue(TEXT("Color"), TransparentColor);
+		}
+
+		NewSnapshot->BackgroundMode = EThumbnailBackgroundMode::Transparent;
+		NewSnapshot->KeyingParams = FThumbnailKeyingParams::Make(TransparentColor, BackgroundCutoffThreshold);
+	}
+	else if (UseCustomBackgroundMaterial)
+	{
+		NewSnapshot->BackgroundMode = EThumbnailBackgroundMode::CustomMaterial;
+	}
+
+	return NewSnapshot;
+}
@@ -0,0 +1,112 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailToTextureStats.h"
+
+#include <atomic>
+
+DEFINE_STAT(STAT_ThumbnailToTexture_LoadAsset);
+DEFINE_STAT(STAT_ThumbnailToTexture_SceneSetup);
+DEFINE_STAT(STAT_ThumbnailToTexture_StreamingWait);
+DEFINE_STAT(STAT_ThumbnailToTexture_Render);
+DEFINE_STAT(STAT_ThumbnailToTexture_Readback);
+DEFINE_STAT(STAT_ThumbnailToTexture_Keying);
+DEFINE_STAT(STAT_ThumbnailToTexture_DerivedData);
+DEFINE_STAT(STAT_ThumbnailToTexture_CachedRead);
+DEFINE_STAT(STAT_ThumbnailToTexture_MipGeneration);
+DEFINE_STAT(STAT_ThumbnailToTexture_TextureBuild);
+DEFINE_STAT(STAT_ThumbnailToTexture_TextureCompileWait);
+DEFINE_STAT(STAT_ThumbnailToTexture_Save);
+DEFINE_STAT(STAT_ThumbnailToTexture_ImageWrite);
+
+DEFINE_STAT(STAT_ThumbnailToTexture_NumLoadAsset);
+DEFINE_STAT(STAT_ThumbnailToTexture_NumSceneSetup);
+DEFINE_STAT(STAT_ThumbnailToTexture_NumStreamingWait);
+DEFINE_STAT(STAT_ThumbnailToTexture_NumRender);
+DEFINE_STAT(STAT_ThumbnailToTexture_NumReadback);
+DEFINE_STAT(STAT_ThumbnailToTexture_NumKeying);
+DEFINE_STAT(STAT_ThumbnailToTexture_NumDerivedData);
+DEFINE_STAT(STAT_ThumbnailToTexture_NumCachedRead);
+DEFINE_STAT(STAT_ThumbnailToTexture_NumMipGeneration);
+DEFINE_STAT(STAT_ThumbnailToTexture_NumTextureBuild);
+DEFINE_STAT(STAT_ThumbnailToTexture_NumTextureCompileWait);
+DEFINE_STAT(STAT_ThumbnailToTexture_NumSave);
+DEFINE_STAT(STAT_ThumbnailToTexture_NumImageWrite);
+
+TRACE_DECLARE_INT_COUNTER(ThumbnailToTexture_NumLoadAsset, TEXT("ThumbnailToTexture/LoadAsset"));
+TRACE_DECLARE_INT_COUNTER(ThumbnailToTexture_NumSceneSetup, TEXT("ThumbnailToTexture/SceneSetup"));
+TRACE_DECLARE_INT_COUNTER(ThumbnailToTexture_NumStreamingWait, TEXT("ThumbnailToTexture/StreamingWait"));
+TRACE_DECLARE_INT_COUNTER(ThumbnailToTexture_NumRender, TEXT("ThumbnailToTexture/Render"));
+TRACE_DECLARE_INT_COUNTER(ThumbnailToTexture_NumReadback, TEXT("ThumbnailToTexture/Readback"));
+TRACE_DECLARE_INT_COUNTER(ThumbnailToTexture_NumKeying, TEXT("ThumbnailToTexture/Keying"));
+TRACE_DECLARE_INT_COUNTER(ThumbnailToTexture_NumDerivedData, TEXT("ThumbnailToTexture/DerivedData"));
+TRACE_DECLARE_INT_COUNTER(ThumbnailToTexture_NumCachedRead, TEXT("ThumbnailToTexture/CachedRead"));
+TRACE_DECLARE_INT_COUNTER(ThumbnailToTexture_NumMipGeneration, TEXT("ThumbnailToTexture/MipGeneration"));
+TRACE_DECLARE_INT_COUNTER(ThumbnailToTexture_NumTextureBuild, TEXT("ThumbnailToTexture/TextureBuild"));
+TRACE_DECLARE_INT_COUNTER(ThumbnailToTexture_NumTextureCompileWait, TEXT("ThumbnailToTexture/TextureCompileWait"));
+TRACE_DECLARE_INT_COUNTER(ThumbnailToTexture_NumSave, TEXT("ThumbnailToTexture/Save"));
+TRACE_DECLARE_INT_COUNTER(ThumbnailToTexture_NumImageWrite, TEXT("ThumbnailToTexture/ImageWrite"));
+
+UE_TRACE_CHANNEL_DEFINE(ThumbnailToTextureChannel);
+
+namespace ThumbnailToTextureStats
+{
+	constexpr int32 NumPhases = static_cast<int32>(EThumbnailExportPhase::Num);
+
+	/** Written by the game thread and the workers encoding images */
+	std::atomic<uint64> PhaseCycles[NumPhases] = {};
+	std::atomic<int64> PhaseItems[NumPhases] = {};
+
+	const TCHAR* const PhaseNames[NumPhases] =
+	{
+		TEXT("LoadAsset"),
+		TEXT("SceneSetup"),
+		TEXT("StreamingWait"),
+		TEXT("Render"),
+		TEXT("Readback"),
+		TEXT("Keying"),
+		TEXT("DerivedData"),
+		TEXT("CachedRead"),
+		TEXT("MipGeneration"),
+		TEXT("TextureBuild"),
+		TEXT("TextureCompileWait"),
+		TEXT("Save"),
+		TEXT("ImageWrite")
+	};
+}
+
+FThumbnailExportPhaseTotals FThumbnailExportPhaseTotals::operator-(const FThumbnailExportPhaseTotals& Other) const
+{
+	FThumbnailExportPhaseTotals Result;
+	for (int32 Phase = 0; Phase < ThumbnailToTextureStats::NumPhases; ++Phase)
+	{
+		Result.Seconds[Phase] = Seconds[Phase] - Other.Seconds[Phase];
+		Result.NumItems[Phase] = NumItems[Phase] - Other.NumItems[Phase];
+	}
+	return Result;
+}
+
+const TCHAR* ThumbnailToTextureStats::GetPhaseName(EThumbnailExportPhase Phase)
+{
+	return Phase < EThumbnailExportPhase::Num ? PhaseNames[static_cast<int32>(Phase)] : TEXT("");
+}
+
+void ThumbnailToTextureStats::AddPhaseCycles(EThumbnailExportPhase Phase, uint64 Cycles)
+{
+	PhaseCycles[static_cast<int32>(Phase)].fetch_add(Cycles, std::memory_order_relaxed);
+}
+
+void ThumbnailToTextureStats::AddPhaseItems(EThumbnailExportPhase Phase, int64 NumItems)
+{
+	PhaseItems[static_cast<int32>(Phase)].fetch_add(NumItems, std::memory_order_relaxed);
+}
+
+FThumbnailExportPhaseTotals ThumbnailToTextureStats::GetPhaseTotals()
+{
+	FThumbnailExportPhaseTotals Totals;
+	for (int32 Phase = 0; Phase < NumPhases; ++Phase)
+	{
+		Totals.Seconds[Phase] = FPlatformTime::ToSeconds64(PhaseCycles[Phase].load(std::memory_order_relaxed));
+		Totals.NumItems[Phase] = PhaseItems[Phase].load(std::memory_order_relaxed);
+	}
+	return Totals;
+}
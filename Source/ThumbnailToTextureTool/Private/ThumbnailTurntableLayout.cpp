@@ -0,0 +1,84 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#include "ThumbnailTurntableLayout.h"
+
+#include "ThumbnailTurntableUserData.h"
+#include "Engine/Texture2D.h"
+#include "UObject/MetaData.h"
+#include "UObject/Package.h"
+
+namespace ThumbnailTurntableLayout
+{
+	/** Where earlier exports recorded the layout, cooking strips the package metadata */
+	const FName NumFramesTag(TEXT("ThumbnailTurntable.NumFrames"));
+	const FName NumColumnsTag(TEXT("ThumbnailTurntable.NumColumns"));
+	const FName NumRowsTag(TEXT("ThumbnailTurntable.NumRows"));
+	const FName YawStepTag(TEXT("ThumbnailTurntable.YawStepDegrees"));
+}
+
+FThumbnailTurntableLayout::FThumbnailTurntableLayout(int32 InNumFrames)
+	: NumFrames(FMath::Max(1, InNumFrames))
+{
+	// Same grid as the tiles of a batch, see FThumbnailToTextureExporter::BeginRenderedThumbnail()
+	NumColumns = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumFrames)));
+	NumRows = FMath::DivideAndRoundUp(NumFrames, NumColumns);
+}
+
+FIntRect FThumbnailTurntableLayout::GetFrameRect(const FIntRect& SheetRect, int32 FrameIndex) const
+{
+	check(FrameIndex >= 0 && FrameIndex < NumFrames);
+
+	const FIntPoint FrameSize(SheetRect.Width() / NumColumns, SheetRect.Height() / NumRows);
+	const FIntPoint FrameMin = SheetRect.Min + FIntPoint((FrameIndex % NumColumns) * FrameSize.X, (FrameIndex / NumColumns) * FrameSize.Y);
+	return FIntRect(FrameMin, FrameMin + FrameSize);
+}
+
+void FThumbnailTurntableLayout::WriteToTexture(UTexture2D* Texture) const
+{
+	check(Texture);
+	UMetaData* MetaData = Texture->GetOutermost()->GetMetaData();
+	MetaData->RemoveValue(Texture, ThumbnailTurntableLayout::NumFramesTag);
+	MetaData->RemoveValue(Texture, ThumbnailTurntableLayout::NumColumnsTag);
+	MetaData->RemoveValue(Texture, ThumbnailTurntableLayout::NumRowsTag);
+	MetaData->RemoveValue(Texture, ThumbnailTurntableLayout::YawStepTag);
+
+	if (!IsTurntable())
+	{
+		// An earlier export of the texture may have been a turntable
+		Texture->RemoveUserDataOfClass(UThumbnailTurntableUserData::StaticClass());
+		return;
+	}
+
+	UThumbnailTurntableUserData* UserData = Texture->GetAssetUserData<UThumbnailTurntableUserData>();
+	if (!UserData)
+	{
+		UserData = NewObject<UThumbnailTurntableUserData>(Texture, NAME_None, RF_Transactional);
+		Texture->AddAssetUserData(UserData);
+	}
+
+	UserData->NumFrames = NumFrames;
+	UserData->NumColumns = NumColumns;
+	UserData->NumRows = NumRows;
+	UserData->YawStepDegrees = GetFrameYaw(1);
+}
+
+bool FThumbnailTurntableLayout::ReadFromTexture(const UTexture2D* Texture, FThumbnailTurntableLayout& OutLayout)
+{
+	OutLayout = FThumbnailTurntableLayout();
+
+	const TArray<UAssetUserData*>* UserDataArray = Texture ? Texture->GetAssetUserDataArray() : nullptr;
+	if (!UserDataArray)
+	{
+		return false;
+	}
+
+	for (const UAssetUserData* UserData : *UserDataArray)
+	{
+		if (const UThumbnailTurntableUserData* Turntable = Cast<UThumbnailTurntableUserData>(UserData))
+		{
+			OutLayout = FThumbnailTurntableLayout(Turntable->NumFrames);
+			return OutLayout.IsTurntable();
+		}
+	}
+	return false;
+}
@@ -3,11 +3,15 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "ThumbnailStreamingFence.h"
 #include "ThumbnailRendering/BlueprintThumbnailRenderer.h"
 #include "CustomBlueprintRenderer.generated.h"
 
 class FCustomBlueprintThumbnailScene;
 
+struct FThumbnailImpostorLayout;
+struct FThumbnailToTextureSettingsSnapshot;
+
 UCLASS(config=Editor)
 class THUMBNAILTOTEXTURETOOL_API UCustomBlueprintRenderer : public UDefaultSizedThumbnailRenderer
 {
@@ -18,6 +22,25 @@ public:
 	virtual bool CanVisualizeAsset(UObject* Object) override;
 	virtual void Draw(UObject* Object, int32 X, int32 Y, uint32 Width, uint32 Height, FRenderTarget* RenderTarget, FCanvas* Canvas, bool bAdditionalViewFamily) override;
 	// End UThumbnailRenderer Object
+
+	/**
+	 * Draws several blueprints into one view family, Objects[i] is drawn into Tiles[i] of the render target.
+	 * All the blueprints share a scene, so they cost a single scene render instead of one per blueprint.
+	 * When Settings.NumTurntableFrames is more than 1, each tile is a sprite sheet of the object turning around, see FThumbnailTurntableLayout.
+	 * When Settings.ImpostorGridSize is set, each tile is the render of an octahedral impostor instead, see FThumbnailImpostorLayout.
+	 * @return how long the render waited for the textures and meshes of the batch to stream in, see FThumbnailStreamingFence
+	 */
+	FThumbnailStreamingWaitResult DrawBatch(TArrayView<UObject* const> Objects, TArrayView<const FIntRect> Tiles, FRenderTarget* RenderTarget, FCanvas* Canvas, bool bAdditionalViewFamily, const FThumbnailToTextureSettingsSnapshot& Settings);
+
+	/**
+	 * While at least one caller is in between BeginPersistentScene() and EndPersistentScene(), the preview scene stays populated after a draw
+	 * and the next one only respawns the actors whose blueprint changed. The last call to EndPersistentScene() empties the scene so it doesn't keep assets loaded.
+	 */
+	void BeginPersistentScene();
+	void EndPersistentScene();
+
+	/** Creates the preview scene of DrawBatch() if it doesn't exist yet, called when the module starts so the first export doesn't pay for it */
+	void PrewarmScene();
 	
 	// UObject implementation
 	virtual void BeginDestroy() override;
@@ -28,7 +51,15 @@ public:
 
 private:
 	void OnBlueprintUnloaded(UBlueprint* Blueprint);
-	TClassInstanceThumbnailScene<FCustomBlueprintThumbnailScene, 100> CustomThumbnailScenes;
+
+	/** Draws the layers of the impostors of the blueprints set in the batch scene, Tiles[i] is the render of slot i */
+	void DrawImpostorBatch(TArrayView<const FIntRect> Tiles, FRenderTarget* RenderTarget, FCanvas* Canvas, bool bAdditionalViewFamily, const FThumbnailImpostorLayout& Layout);
+
+	/** Scene of DrawBatch(), not tied to a single class like the ones Draw() keeps in the module's FThumbnailSceneCache */
+	TSharedPtr<FCustomBlueprintThumbnailScene> BatchThumbnailScene;
+
+	/** Callers in between BeginPersistentScene() and EndPersistentScene() */
+	int32 NumPersistentSceneUsers = 0;
 };
 
 
@@ -3,7 +3,6 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "ThumbnailHelpers.h"
 #include "ThumbnailRendering/DefaultSizedThumbnailRenderer.h"
 #include "CustomSkeletalMeshThumbnailRenderer.generated.h"
 
@@ -24,7 +23,4 @@ class THUMBNAILTOTEXTURETOOL_API UCustomSkeletalMeshThumbnailRenderer : public U
 	virtual void BeginDestroy() override;
 
 	virtual void AddAdditionalPreviewSceneContent(UObject* Object, UWorld* PreviewWorld) {}
-
-protected:
-	TObjectInstanceThumbnailScene<FCustomSkeletalMeshThumbnailScene, 128> ThumbnailSceneCache;
 };
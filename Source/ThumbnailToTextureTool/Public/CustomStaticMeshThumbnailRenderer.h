@@ -3,9 +3,13 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "ThumbnailStreamingFence.h"
 #include "ThumbnailRendering/DefaultSizedThumbnailRenderer.h"
 #include "CustomStaticMeshThumbnailRenderer.generated.h"
 
+struct FThumbnailImpostorLayout;
+struct FThumbnailToTextureSettingsSnapshot;
+
 /**
  * 
  */
@@ -19,9 +23,34 @@ class THUMBNAILTOTEXTURETOOL_API UCustomStaticMeshThumbnailRenderer : public UDe
 	virtual void Draw(UObject* Object, int32 X, int32 Y, uint32 Width, uint32 Height, FRenderTarget* RenderTarget, FCanvas* Canvas, bool bAdditionalViewFamily) override;
 	// End UThumbnailRenderer Object
 
+	/**
+	 * Draws several static meshes into one view family, Objects[i] is drawn into Tiles[i] of the render target.
+	 * All the meshes share the scene, so they cost a single scene render instead of one per mesh.
+	 * When Settings.NumTurntableFrames is more than 1, each tile is a sprite sheet of the object turning around, see FThumbnailTurntableLayout.
+	 * When Settings.ImpostorGridSize is set, each tile is the render of an octahedral impostor instead, see FThumbnailImpostorLayout.
+	 * @return how long the render waited for the textures and meshes of the batch to stream in, see FThumbnailStreamingFence
+	 */
+	FThumbnailStreamingWaitResult DrawBatch(TArrayView<UObject* const> Objects, TArrayView<const FIntRect> Tiles, FRenderTarget* RenderTarget, FCanvas* Canvas, bool bAdditionalViewFamily, const FThumbnailToTextureSettingsSnapshot& Settings);
+
+	/**
+	 * While at least one caller is in between BeginPersistentScene() and EndPersistentScene(), the preview scene stays populated after a draw
+	 * and the next one only swaps the meshes that changed. The last call to EndPersistentScene() empties the scene so it doesn't keep assets loaded.
+	 */
+	void BeginPersistentScene();
+	void EndPersistentScene();
+
+	/** Creates the preview scene of DrawBatch() if it doesn't exist yet, called when the module starts so the first export doesn't pay for it */
+	void PrewarmScene();
+
 	// UObject implementation
 	virtual void BeginDestroy() override;
 
 private:
+	/** Draws the layers of the impostors of the meshes set in the scene, Tiles[i] is the render of slot i */
+	void DrawImpostorBatch(TArrayView<const FIntRect> Tiles, FRenderTarget* RenderTarget, FCanvas* Canvas, bool bAdditionalViewFamily, const FThumbnailImpostorLayout& Layout);
+
 	class FCustomStaticMeshThumbnailScene* ThumbnailScene;
+
+	/** Callers in between BeginPersistentScene() and EndPersistentScene() */
+	int32 NumPersistentSceneUsers;
 };
@@ -3,11 +3,14 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "ThumbnailImpostorLayout.h"
+#include "ThumbnailStreamingFence.h"
 #include "UObject/Object.h"
 
 // Preview scenes
 
 class FSceneViewFamily;
+class UMaterialInstanceDynamic;
 class USceneThumbnailInfo;
 
 class FCustomThumbnailPreviewScene : public FPreviewScene, public FTickableEditorObject
@@ -21,23 +24,84 @@ public:
 	/** Allocates then adds an FSceneView to the ViewFamily. */
 	[[nodiscard]] FSceneView* CreateView(FSceneViewFamily* ViewFamily, int32 X, int32 Y, uint32 SizeX, uint32 SizeY) const;
 
+	/**
+	 * Allocates then adds the FSceneView of one slot of a batch to the ViewFamily.
+	 * The objects of a batch are laid out on a grid far enough apart not to shadow each other, each view hides the other slots.
+	 * YawOffsetDegrees turns the camera further around the orbit, several views of the same slot make the frames of a turntable.
+	 */
+	[[nodiscard]] FSceneView* CreateSlotView(FSceneViewFamily* ViewFamily, int32 SlotIndex, int32 X, int32 Y, uint32 SizeX, uint32 SizeY, float YawOffsetDegrees = 0.f) const;
+
+	/**
+	 * Allocates then adds the orthographic views of one layer of the impostor of a slot to the ViewFamily, one per cell of the grid drawn at Tile.
+	 * Each view frames the bounding sphere of the slot, so the asset has the same scale from every direction.
+	 * The family must have the VisualizeBuffer show flag set for the normal layer.
+	 * The depth layer is the distance into the bounding sphere, 0 at its front and 1 at its back, see GetImpostorDepthMaterial().
+	 * @return the first view added, nullptr if the tile is empty
+	 */
+	FSceneView* CreateSlotImpostorViews(FSceneViewFamily* ViewFamily, int32 SlotIndex, const FIntRect& Tile, const FThumbnailImpostorLayout& Layout, EThumbnailImpostorLayer Layer) const;
+
 	/* Begin FTickableEditorObject */
 	virtual void Tick(float DeltaTime) override;
 	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Always; }
 	virtual TStatId GetStatId() const override;
 	/* End FTickableEditorObject */
 
-	/** Sets the custom material background */
+	// FGCObject interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+	/** Sets the custom material background, does nothing if the same background is already applied */
 	void SetMaterial(UMaterial* Material, bool IsTransparent);
 
+	/**
+	 * Forces the textures and meshes of every slot fully resident and waits at most TimeoutSeconds for them to stream in.
+	 * Called once the objects are set and before the views are created, so the render doesn't capture blurry mips.
+	 */
+	FThumbnailStreamingWaitResult WaitForStreaming(double TimeoutSeconds) const;
+
 protected:
 	/** Useful for setting a custom background color or translucent background */
 	UStaticMeshComponent* BackgroundPlaneComponent;
 	UStaticMeshComponent* BackgroundSkySphereComponent;
+
+	/** Inputs of the last SetMaterial() call, re-assigning the same material would dirty the components' render state */
+	TWeakObjectPtr<UMaterial> AppliedMaterial;
+	bool bAppliedTransparent = false;
+	bool bMaterialApplied = false;
+
+	/** Post process material drawing the depth layer of the impostors, and its instance for each slot, created on the first impostor draw */
+	mutable TObjectPtr<UMaterial> ImpostorDepthMaterial;
+	mutable TArray<TObjectPtr<UMaterialInstanceDynamic>> SlotImpostorDepthMaterials;
 	
 	/** Helper function to get the bounds offset to display an asset */
 	float GetBoundsZOffset(const FBoxSphereBounds& Bounds) const;
 
+	/** Number of objects currently laid out in the scene, see CreateSlotView() */
+	virtual int32 GetNumSlots() const { return 1; }
+
+	/** Same as GetViewMatrixParameters() for one slot of a batch, OutOrigin includes the slot offset */
+	virtual void GetSlotViewMatrixParameters(int32 SlotIndex, const float InFOVDegrees, FVector& OutOrigin, float& OutOrbitPitch, float& OutOrbitYaw, float& OutOrbitZoom) const;
+
+	/** Appends the primitives drawn for a slot, they get hidden from the views of the other slots */
+	virtual void GetSlotPrimitiveComponents(int32 SlotIndex, TArray<const UPrimitiveComponent*>& OutComponents) const {}
+
+	/** Appends the primitives of every slot but SlotIndex */
+	void GetOtherSlotPrimitiveComponents(int32 SlotIndex, TArray<const UPrimitiveComponent*>& OutComponents) const;
+
+	/**
+	 * @return the depth material of a slot, set to write the scene depth remapped from [DepthMin, DepthMin + DepthRange] to [0, 1].
+	 * The material replaces the tonemapper, so the remapped depth lands unchanged in the 8-bit render target.
+	 */
+	UMaterialInstanceDynamic* GetImpostorDepthMaterial(int32 SlotIndex, double DepthMin, double DepthRange) const;
+
+	/** @return world bounds of the primitives of a slot, slot offset included */
+	FBoxSphereBounds GetSlotBounds(int32 SlotIndex) const;
+
+	/** @return distance between two slots of a batch whose biggest object has the given bounds radius */
+	static float GetSlotSpacing(float MaxSphereRadius);
+
+	/** @return world offset of a slot, slots are laid out on a grid centered on the origin */
+	static FVector GetSlotOffset(int32 SlotIndex, int32 NumSlots, float SlotSpacing);
+
 	/**
 	  * Gets parameters to create a view matrix to be used by CreateView(). Implemented in children classes.
 	  * @param InFOVDegrees  The FOV used to display the thumbnail. Often used to calculate the output parameters.
@@ -61,22 +125,43 @@ public:
 protected:
 	// FThumbnailPreviewScene implementation
 	virtual void GetViewMatrixParameters(const float InFOVDegrees, FVector& OutOrigin, float& OutOrbitPitch, float& OutOrbitYaw, float& OutOrbitZoom) const override;
+	virtual int32 GetNumSlots() const override { return NumSlots; }
+	virtual void GetSlotViewMatrixParameters(int32 SlotIndex, const float InFOVDegrees, FVector& OutOrigin, float& OutOrbitPitch, float& OutOrbitYaw, float& OutOrbitZoom) const override;
+	virtual void GetSlotPrimitiveComponents(int32 SlotIndex, TArray<const UPrimitiveComponent*>& OutComponents) const override;
 
 	/** Sets the object (class or blueprint) used in the next CreateView() */
 	void SpawnPreviewActor(class UClass* Obj);
 
+	/** Sets the objects (class or blueprint) of a batch, Classes[i] is used by CreateSlotView(i) */
+	void SpawnPreviewActors(TArrayView<class UClass* const> Classes);
+
 	/** Get the scene thumbnail info to use for the object currently being rendered */
 	virtual USceneThumbnailInfo* GetSceneThumbnailInfo(const float TargetDistance) const = 0;
 
+	/** Get the scene thumbnail info to use for the object of a slot of a batch */
+	virtual USceneThumbnailInfo* GetSlotSceneThumbnailInfo(int32 SlotIndex, const float TargetDistance) const { return GetSceneThumbnailInfo(TargetDistance); }
+
 	FBoxSphereBounds GetPreviewActorBounds() const;
 
+	/** Bounds of the visualized components of an actor */
+	static FBoxSphereBounds GetActorBounds(const AActor* Actor);
+
 private:
 
 	/** Clears out any stale actors in this scene if PreviewActor enters a stale state */
 	void ClearStaleActors();
 
+	/** @return the preview actor of a slot, slot 0 is PreviewActor */
+	AActor* GetSlotActor(int32 SlotIndex) const;
+
 	int32 NumStartingActors;
 	TWeakObjectPtr<class AActor> PreviewActor;
+
+	/** Preview actors of the slots 1 and up of a batch */
+	TArray<TWeakObjectPtr<class AActor>> BatchPreviewActors;
+
+	int32 NumSlots;
+	float SlotSpacing;
 };
 
 class FCustomBlueprintThumbnailScene : public FCustomClassActorThumbnailScene
@@ -87,6 +172,9 @@ public:
 
 	/** Sets the static mesh to use in the next CreateView() */
 	void SetBlueprint(class UBlueprint* Blueprint);
+
+	/** Sets the blueprints of a batch, Blueprints[i] is used by CreateSlotView(i) */
+	void SetBlueprints(TArrayView<class UBlueprint* const> Blueprints);
 	
 	/** Refreshes components for the specified blueprint */
 	void BlueprintChanged(class UBlueprint* Blueprint);
@@ -95,10 +183,14 @@ protected:
 	
 	/** Get the scene thumbnail info to use for the object currently being rendered */
 	virtual USceneThumbnailInfo* GetSceneThumbnailInfo(const float TargetDistance) const override;
+	virtual USceneThumbnailInfo* GetSlotSceneThumbnailInfo(int32 SlotIndex, const float TargetDistance) const override;
 
 private:
 	/** The blueprint that is currently being rendered. NULL when not rendering. */
 	TWeakObjectPtr<class UBlueprint> CurrentBlueprint;
+
+	/** The blueprints of the slots 1 and up of a batch */
+	TArray<TWeakObjectPtr<class UBlueprint>> BatchBlueprints;
 };
 
 class FCustomSkeletalMeshThumbnailScene : public FCustomThumbnailPreviewScene
@@ -110,6 +202,9 @@ public:
 	/** Sets the skeletal mesh to use in the next CreateView() */
 	void SetSkeletalMesh(class USkeletalMesh* InSkeletalMesh);
 
+	/** Sets the skeletal meshes of a batch, SkeletalMeshes[i] is used by CreateSlotView(i) */
+	void SetSkeletalMeshes(TArrayView<class USkeletalMesh* const> SkeletalMeshes);
+
 	/** Set whether to draw debug skeleton */
 	void SetDrawDebugSkeleton(bool bInDrawDebugSkeleton, const FLinearColor& InSkeletonColor);
 	
@@ -119,11 +214,26 @@ public:
 protected:
 	// FThumbnailPreviewScene implementation
 	virtual void GetViewMatrixParameters(const float InFOVDegrees, FVector& OutOrigin, float& OutOrbitPitch, float& OutOrbitYaw, float& OutOrbitZoom) const override;
+	virtual int32 GetNumSlots() const override { return NumSlots; }
+	virtual void GetSlotViewMatrixParameters(int32 SlotIndex, const float InFOVDegrees, FVector& OutOrigin, float& OutOrbitPitch, float& OutOrbitYaw, float& OutOrbitZoom) const override;
+	virtual void GetSlotPrimitiveComponents(int32 SlotIndex, TArray<const UPrimitiveComponent*>& OutComponents) const override;
 
 private:
+	/** Spawns the actor of an additional slot of a batch */
+	class ASkeletalMeshActor* SpawnPreviewActor();
+
+	/** @return the preview actor of a slot, slot 0 is PreviewActor */
+	class ASkeletalMeshActor* GetSlotActor(int32 SlotIndex) const;
+
 	/** The skeletal mesh actor used to display all skeletal mesh thumbnails */
 	class ASkeletalMeshActor* PreviewActor;
 
+	/** Preview actors of the slots 1 and up of a batch */
+	TArray<class ASkeletalMeshActor*> BatchPreviewActors;
+
+	int32 NumSlots = 1;
+	float SlotSpacing = 0.f;
+
 	/** The color used to draw the debug skeleton */
 	FLinearColor DrawDebugColor = FLinearColor::White;
 	
@@ -140,15 +250,33 @@ public:
 	/** Sets the static mesh to use in the next CreateView() */
 	void SetStaticMesh(class UStaticMesh* StaticMesh);
 
+	/** Sets the static meshes of a batch, StaticMeshes[i] is used by CreateSlotView(i) */
+	void SetStaticMeshes(TArrayView<class UStaticMesh* const> StaticMeshes);
+
 	/** Sets override materials for the static mesh  */
 	void SetOverrideMaterials(const TArray<class UMaterialInterface*>& OverrideMaterials);
 
 protected:
 	// FThumbnailPreviewScene implementation
 	virtual void GetViewMatrixParameters(const float InFOVDegrees, FVector& OutOrigin, float& OutOrbitPitch, float& OutOrbitYaw, float& OutOrbitZoom) const override;
+	virtual int32 GetNumSlots() const override { return NumSlots; }
+	virtual void GetSlotViewMatrixParameters(int32 SlotIndex, const float InFOVDegrees, FVector& OutOrigin, float& OutOrbitPitch, float& OutOrbitYaw, float& OutOrbitZoom) const override;
+	virtual void GetSlotPrimitiveComponents(int32 SlotIndex, TArray<const UPrimitiveComponent*>& OutComponents) const override;
 
 private:
+	/** Spawns the actor of an additional slot of a batch */
+	class AStaticMeshActor* SpawnPreviewActor();
+
+	/** @return the preview actor of a slot, slot 0 is PreviewActor */
+	class AStaticMeshActor* GetSlotActor(int32 SlotIndex) const;
+
 	/** The static mesh actor used to display all static mesh thumbnails */
 	class AStaticMeshActor* PreviewActor;
+
+	/** Preview actors of the slots 1 and up of a batch */
+	TArray<class AStaticMeshActor*> BatchPreviewActors;
+
+	int32 NumSlots = 1;
+	float SlotSpacing = 0.f;
 };
 
@@ -7,6 +7,8 @@
 #include "CustomStaticMeshThumbnailRenderer.h"
 #include "Modules/ModuleManager.h"
 
+class FThumbnailRenderTargetPool;
+class FThumbnailSceneCache;
 class UThumbnailToTextureSettings;
 
 class IThumbnailToTextureToolModule
@@ -68,10 +70,34 @@ public:
 		return *ThumbnailRenderer;
 	}
 
+	/**
+	* @return reference to the pool of render targets used to draw thumbnails, lives in the module
+	*/
+	static inline FThumbnailRenderTargetPool& GetRenderTargetPool()
+	{
+		IThumbnailToTextureToolModule& Module = IsInGameThread() ? Get() : FModuleManager::GetModuleChecked<IThumbnailToTextureToolModule>("ThumbnailToTextureTool");
+		FThumbnailRenderTargetPool* RenderTargetPool = Module.GetRenderTargetPoolInstance();
+		check(RenderTargetPool);
+		return *RenderTargetPool;
+	}
+
+	/**
+	* @return reference to the cache of preview scenes shared by the custom renderers, lives in the module
+	*/
+	static inline FThumbnailSceneCache& GetPreviewSceneCache()
+	{
+		IThumbnailToTextureToolModule& Module = IsInGameThread() ? Get() : FModuleManager::GetModuleChecked<IThumbnailToTextureToolModule>("ThumbnailToTextureTool");
+		FThumbnailSceneCache* SceneCache = Module.GetPreviewSceneCacheInstance();
+		check(SceneCache);
+		return *SceneCache;
+	}
+
 protected:
 	virtual UThumbnailToTextureSettings* GetEditorSettingsInstance() const = 0;
 	virtual UCustomBlueprintRenderer* GetCustomBlueprintThumbnailRendererInstance() = 0;
 	virtual UCustomStaticMeshThumbnailRenderer* GetCustomStaticMeshThumbnailRendererInstance() = 0;
 	virtual UCustomSkeletalMeshThumbnailRenderer* GetCustomSkeletalMeshThumbnailRendererInstance() = 0;
+	virtual FThumbnailRenderTargetPool* GetRenderTargetPoolInstance() = 0;
+	virtual FThumbnailSceneCache* GetPreviewSceneCacheInstance() = 0;
 	
 };
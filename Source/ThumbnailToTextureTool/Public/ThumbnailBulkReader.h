@@ -0,0 +1,33 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ObjectThumbnail.h"
+
+/**
+ * Thumbnail saved in a package, to be read by ThumbnailBulkReader::ReadThumbnails()
+ */
+struct FCachedThumbnailRead
+{
+	/** File of the package holding the thumbnail */
+	FString PackageFilename;
+
+	/** Path of the object within its package, the asset name for assets */
+	FString ObjectPathInPackage;
+
+	/** Decompressed thumbnail, valid if bFound */
+	FObjectThumbnail Thumbnail;
+	bool bFound = false;
+};
+
+/**
+ * Reads the thumbnails saved in many packages at once, replacing one ThumbnailTools::LoadThumbnailsFromPackage() call per asset on the game thread.
+ * Packages are memory mapped so only the summary, the thumbnail table and the thumbnails themselves are paged in,
+ * and they are parsed and their thumbnails decompressed in parallel on the task graph.
+ */
+namespace ThumbnailBulkReader
+{
+	/** Fills the thumbnails of Reads, the reads of a same package share one pass over its thumbnail table */
+	THUMBNAILTOTEXTURETOOL_API void ReadThumbnails(TArrayView<FCachedThumbnailRead> Reads);
+}
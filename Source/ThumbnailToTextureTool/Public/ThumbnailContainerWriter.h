@@ -0,0 +1,78 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ThumbnailContainer.h"
+#include "Tasks/Pipe.h"
+#include "Tasks/Task.h"
+
+class IFileHandle;
+
+/**
+ * Appends thumbnails to a container. Entries are encoded on the task graph's workers and appended one at a time in the order their
+ * encodes finish, the export loop only hands the pixels over. The container can be read once Commit() wrote the index.
+ * A container left without an index, by a crash in the middle of an export, is started over by the next writer.
+ */
+class THUMBNAILTOTEXTURETOOL_API FThumbnailContainerWriter
+{
+public:
+	FThumbnailContainerWriter(const FString& InFilename, EThumbnailContainerEntryFormat InFormat);
+
+	/** Rolls back the entries added since the last Commit() */
+	~FThumbnailContainerWriter();
+
+	/** Opens the container, keeping the entries of an existing one. False if the file can't be written */
+	bool Open();
+
+	/**
+	 * Encodes Size.X * Size.Y pixels, top row first, and appends them as the thumbnail of AssetPath, replacing any former one.
+	 * Called on the game thread. @return task that is true once the entry is appended
+	 */
+	UE::Tasks::TTask<bool> Add(FStringView AssetPath, FIntPoint Size, TArray<FColor>&& Pixels);
+
+	/**
+	 * True if the last index has a thumbnail for AssetPath. False for every asset when the container was started over,
+	 * so the records of the export manifest pointing at the container can't skip assets whose thumbnails are gone.
+	 */
+	bool Contains(FStringView AssetPath) const;
+
+	/** Waits for the added entries and appends the index of every entry, false if it couldn't be written */
+	bool Commit();
+
+	/** Waits for the added entries and appends the index of the committed entries only, the added ones stay behind as dead bytes */
+	bool Rollback();
+
+	const FString& GetFilename() const { return Filename; }
+
+private:
+	/** Appends an entry at the end of the file, on the pipe */
+	bool Append(uint64 PathHash, FIntPoint Size, const TArray64<uint8>& Data);
+
+	/** Pads the file up to the next multiple of ThumbnailContainer::Alignment */
+	bool AlignEnd();
+
+	/** Appends the index and the trailer, if anything was appended since the last ones */
+	bool WriteIndex();
+
+	FString Filename;
+	EThumbnailContainerEntryFormat Format;
+
+	TUniquePtr<IFileHandle> File;
+
+	/** Size of the file, touched by the pipe's tasks while entries are added */
+	int64 EndOffset;
+
+	/** Size of the file after the last index */
+	int64 IndexEndOffset;
+
+	/** Appends run one at a time on the pipe, the encodes before them in parallel */
+	UE::Tasks::FPipe Pipe;
+	TArray<UE::Tasks::TTask<bool>> PendingAppends;
+
+	/** Entries of the last index, by path hash */
+	TMap<uint64, FThumbnailContainerIndexEntry> CommittedEntries;
+
+	/** Entries appended since, in order, touched by the pipe's tasks */
+	TArray<FThumbnailContainerIndexEntry> AddedEntries;
+};
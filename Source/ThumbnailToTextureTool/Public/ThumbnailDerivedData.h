@@ -0,0 +1,24 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Final pixels of rendered thumbnails (keyed and filtered down to the exported size) stored in the engine's Derived Data Cache,
+ * so a workstation or build machine with a warm local or shared cache doesn't render the icons other machines already rendered.
+ * Entries are keyed by the hash of FThumbnailInputHasher, which covers the asset, its dependencies, the export settings and
+ * the background material with its keying parameters. Anything changing the final pixels must be part of that hash,
+ * a missing input gives stale hits that spread to every machine sharing the cache.
+ */
+namespace ThumbnailDerivedData
+{
+	/** @return cache key of the thumbnail whose inputs hash to InputHash */
+	THUMBNAILTOTEXTURETOOL_API FString BuildKey(const FString& InputHash);
+
+	/** Fetches the pixels stored under Key, false on a miss or if the cached data is invalid */
+	THUMBNAILTOTEXTURETOOL_API bool Get(const FString& Key, FStringView DebugContext, FIntPoint& OutSize, TArray<FColor>& OutPixels);
+
+	/** Stores Size.X * Size.Y pixels, top row first, under Key */
+	THUMBNAILTOTEXTURETOOL_API void Put(const FString& Key, FStringView DebugContext, FIntPoint Size, const FColor* Pixels);
+}
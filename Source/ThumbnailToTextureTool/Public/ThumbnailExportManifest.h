@@ -0,0 +1,50 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Remembers, for every exported asset, the hash of everything its thumbnail texture was made from (see FThumbnailInputHasher),
+ * so unchanged assets can be skipped by the next export. Stored as JSON, by default in Saved/ThumbnailToTexture/ExportManifest.json.
+ */
+class THUMBNAILTOTEXTURETOOL_API FThumbnailExportManifest
+{
+public:
+	explicit FThumbnailExportManifest(const FString& InFilename);
+
+	static FString GetDefaultFilename();
+
+	/** Reads the manifest file, a missing file is an empty manifest. False if the file can't be parsed */
+	bool Load();
+
+	/** Writes the manifest file if it changed since Load() */
+	bool Save();
+
+	/**
+	 * True if the asset was exported from the same inputs into a texture package that still exists.
+	 * When exporting image files, TexturePackageName is the absolute filename of the image instead.
+	 */
+	bool IsUpToDate(const FString& SourceAssetPath, const FString& InputHash, const FString& TexturePackageName) const;
+
+	/** Records a successful export */
+	void Record(const FString& SourceAssetPath, const FString& InputHash, const FString& TexturePackageName);
+
+	/** Forgets an asset so its next export isn't skipped */
+	void Remove(const FString& SourceAssetPath);
+
+	int32 Num() const { return Entries.Num(); }
+
+private:
+	struct FEntry
+	{
+		FString InputHash;
+		FString TexturePackageName;
+	};
+
+	/** Entries by object path of the source asset */
+	TMap<FString, FEntry> Entries;
+
+	FString Filename;
+	bool bModified;
+};
@@ -0,0 +1,52 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TickableEditorObject.h"
+#include "ThumbnailToTextureExporter.h"
+
+class SNotificationItem;
+
+/**
+ * Export started from the Content Browser, spread over editor frames so the editor stays responsive.
+ * Each tick exports assets for UThumbnailToTextureSettings::ExportFrameBudgetMs, progress and the time left are shown
+ * in a notification whose Cancel button throws away everything that wasn't saved yet.
+ */
+class THUMBNAILTOTEXTURETOOL_API FThumbnailExportTask : public FTickableEditorObject
+{
+public:
+	explicit FThumbnailExportTask(const TArray<FAssetData>& InAssets);
+
+	/** Cancels the export if it is still running */
+	virtual ~FThumbnailExportTask() override;
+
+	/** Stops exporting, the textures not saved yet are discarded */
+	void Cancel();
+
+	/** True once every asset was exported and saved, or the export was cancelled */
+	bool IsFinished() const { return bFinished; }
+
+	// Begin FTickableEditorObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override { return !bFinished; }
+	virtual TStatId GetStatId() const override;
+	// End FTickableEditorObject Interface
+
+private:
+	void UpdateNotification();
+	void Finish(bool bCancelled);
+
+	TArray<FAssetData> Assets;
+	int32 NextAssetIndex;
+
+	/** Released once finished, the task is kept by the module until the next export starts */
+	TUniquePtr<FThumbnailToTextureExporter> Exporter;
+	FThumbnailExportStats Stats;
+	double StartTime;
+
+	TSharedPtr<SNotificationItem> Notification;
+
+	bool bFinished;
+};
@@ -0,0 +1,86 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Background the thumbnails are rendered with, see UThumbnailToTextureSettings
+ */
+enum class EThumbnailBackgroundMode : uint8
+{
+	/** Black background, nothing is keyed */
+	Opaque,
+
+	/** UThumbnailToTextureSettings::BackgroundMaterial is kept in the texture, nothing is keyed */
+	CustomMaterial,
+
+	/** Pixels close to the color of the translucent background material are made transparent */
+	Transparent
+};
+
+/**
+ * Keying of the transparent background, as inclusive 8 bits ranges per channel.
+ * A pixel is keyed when each of its channels is within [Min, Max].
+ */
+struct THUMBNAILTOTEXTURETOOL_API FThumbnailKeyingParams
+{
+	FColor Min = FColor(255, 255, 255, 255);
+	FColor Max = FColor(0, 0, 0, 0);
+
+	/** False when no pixel can ever be keyed */
+	bool bCanMatch = false;
+
+	/**
+	 * Builds the ranges matching the pixels the former float test accepted,
+	 * FColor::ReinterpretAsLinear().Equals(KeyColor, Threshold), for each of the 256 values of a channel
+	 */
+	static FThumbnailKeyingParams Make(const FLinearColor& KeyColor, float Threshold);
+};
+
+/**
+ * CPU pixel operations applied to the read back thumbnails before they are stored in a texture
+ */
+namespace ThumbnailImageUtils
+{
+	/**
+	 * Reduces an image rendered at Factor times the output size with a Factor x Factor box filter.
+	 * The 4 channels are averaged plainly, like KeyAndDownsample() in the modes that key nothing.
+	 * SrcSize must be a multiple of Factor, OutDest is resized to SrcSize / Factor.
+	 */
+	THUMBNAILTOTEXTURETOOL_API void DownsampleBox(TArrayView<const FColor> Src, FIntPoint SrcSize, int32 Factor, TArray<FColor>& OutDest);
+
+	/**
+	 * Keys and downsamples in a single pass over the pixels, writing straight to Dest, e.g. a locked texture source mip.
+	 * In Transparent mode colors are weighted by their alpha, so keyed out background pixels don't bleed into the edges.
+	 * The other modes average the 4 channels plainly, their alpha isn't coverage and may be 0 everywhere.
+	 * Dest must hold (SrcSize / Factor) pixels and can't overlap Src unless Factor is 1.
+	 */
+	THUMBNAILTOTEXTURETOOL_API void KeyAndDownsample(EThumbnailBackgroundMode Mode, const FThumbnailKeyingParams& Params, TArrayView<const FColor> Src, FIntPoint SrcSize, int32 Factor, FColor* Dest);
+
+	/**
+	 * Clears the alpha of the background pixels in place, 4 pixels per SSE2 or NEON instruction.
+	 * The modes that key nothing return right away.
+	 */
+	THUMBNAILTOTEXTURETOOL_API void KeyBackground(EThumbnailBackgroundMode Mode, TArrayView<FColor> Pixels, const FThumbnailKeyingParams& Params);
+
+	/** Same as KeyBackground() but writes to Dest, which holds Src.Num() pixels. The modes that key nothing copy */
+	THUMBNAILTOTEXTURETOOL_API void KeyBackground(EThumbnailBackgroundMode Mode, TArrayView<const FColor> Src, FColor* Dest, const FThumbnailKeyingParams& Params);
+
+	/** @return number of mips of a full chain down to 1x1, 1 when Size isn't a power of two in both directions */
+	THUMBNAILTOTEXTURETOOL_API int32 GetNumMips(FIntPoint Size);
+
+	/** @return pixels of the first NumMips mips of an image of Size, stored mip after mip */
+	THUMBNAILTOTEXTURETOOL_API int64 GetMipChainNumPixels(FIntPoint Size, int32 NumMips);
+
+	/**
+	 * Fills the mips after the first one of a chain stored mip after mip, each half the size of the previous one.
+	 * When bAlphaWeighted, colors are weighted by their alpha like KeyAndDownsample() in Transparent mode, so keyed out background pixels don't darken the edges
+	 * of the small mips. Otherwise the 4 channels are plainly averaged, for images whose alpha isn't coverage and may be 0 everywhere.
+	 * Chain holds GetMipChainNumPixels(Size, NumMips) pixels, mip 0 already filled, Size is a power of two in both directions.
+	 */
+	THUMBNAILTOTEXTURETOOL_API void BuildMipChain(TArrayView<FColor> Chain, FIntPoint Size, int32 NumMips, bool bAlphaWeighted);
+
+	/** Per pixel float version of KeyBackground() in Transparent mode, kept to check and measure the vectorized one */
+	THUMBNAILTOTEXTURETOOL_API void KeyBackgroundReference(TArrayView<FColor> Pixels, const FLinearColor& KeyColor, float Threshold);
+}
@@ -0,0 +1,29 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ThumbnailToTextureSettings.h"
+#include "Tasks/Task.h"
+
+/**
+ * Writes exported pixels to image files with the engine's image wrappers, for the output formats other than EThumbnailOutputFormat::Texture2D.
+ * Encoding and writing run on the task graph's workers, the export loop only hands the pixels over.
+ */
+namespace ThumbnailImageWriter
+{
+	/** @return file extension of the format with its dot, empty for the formats that aren't an image file */
+	THUMBNAILTOTEXTURETOOL_API const TCHAR* GetExtension(EThumbnailOutputFormat Format);
+
+	/** Loads the image wrappers, on the game thread before Encode() is called from other threads */
+	THUMBNAILTOTEXTURETOOL_API void LoadImageWrappers();
+
+	/** Encodes Size.X * Size.Y pixels, top row first, to a PNG, JPEG or EXR file in memory. Thread safe once LoadImageWrappers() was called */
+	THUMBNAILTOTEXTURETOOL_API bool Encode(EThumbnailOutputFormat Format, FIntPoint Size, TArray<FColor>& Pixels, TArray64<uint8>& OutData);
+
+	/**
+	 * Encodes Size.X * Size.Y pixels, top row first, and writes them to Filename, creating its directories. The pixels are freed once encoded.
+	 * Called on the game thread. @return task that is true if the file was written
+	 */
+	THUMBNAILTOTEXTURETOOL_API UE::Tasks::TTask<bool> Launch(EThumbnailOutputFormat Format, FIntPoint Size, TArray<FColor>&& Pixels, FString Filename);
+}
@@ -0,0 +1,89 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ThumbnailImageUtils.h"
+
+class UTexture2D;
+
+/**
+ * Layers of the render of an impostor, stacked top to bottom, each a grid of one view per direction
+ */
+enum class EThumbnailImpostorLayer : uint8
+{
+	/** Lit like the thumbnails, keyed with the export's background mode */
+	Color,
+
+	/** The engine's WorldNormal buffer visualization */
+	WorldNormal,
+
+	/** Depth into the bounding sphere of the asset, 0 at its front and 1 at its back */
+	SceneDepth,
+
+	Num
+};
+
+/**
+ * Octahedral impostor atlas of an asset, a square grid of orthographic views whose directions cover the upper hemisphere
+ * or the whole sphere of directions. The cell at (X, Y) of a GridSize x GridSize grid is the direction encoded by
+ * UV = (X, Y) / (GridSize - 1), see OctahedronToDirection(), so the border cells see the horizon of a hemisphere.
+ *
+ * Every layer of EThumbnailImpostorLayer is rendered for each view, then the exported atlas holds two grids stacked top to bottom:
+ * the color with its alpha, then the world normal with the depth in its alpha. The depth is normalized to the bounding sphere
+ * of the asset, 0 at the front of the sphere and 1 at its back or where nothing was drawn, so every view uses the same scale.
+ */
+struct THUMBNAILTOTEXTURETOOL_API FThumbnailImpostorLayout
+{
+	FThumbnailImpostorLayout() = default;
+	FThumbnailImpostorLayout(int32 InGridSize, bool bInFullSphere);
+
+	/** Views along each side of the grid, 0 when exporting thumbnails */
+	int32 GridSize = 0;
+
+	/** The views cover the whole sphere of directions instead of the upper hemisphere */
+	bool bFullSphere = false;
+
+	static constexpr int32 NumRenderedLayers = static_cast<int32>(EThumbnailImpostorLayer::Num);
+	static constexpr int32 NumAtlasLayers = 2;
+
+	bool IsImpostor() const { return GridSize > 0; }
+
+	/** @return size of the render of one asset, every layer stacked, when each view is ViewSize */
+	FIntPoint GetRenderSize(FIntPoint ViewSize) const { return FIntPoint(ViewSize.X * GridSize, ViewSize.Y * GridSize * NumRenderedLayers); }
+
+	/** @return size of the atlas built by BuildAtlas() from a render of RenderSize */
+	FIntPoint GetAtlasSize(FIntPoint RenderSize) const { return FIntPoint(RenderSize.X, RenderSize.Y / NumRenderedLayers * NumAtlasLayers); }
+
+	/** @return area of a view within a render drawn at RenderRect, whose size is a multiple of the grid */
+	FIntRect GetViewRect(const FIntRect& RenderRect, EThumbnailImpostorLayer Layer, int32 CellX, int32 CellY) const;
+
+	/** @return unit direction from the asset towards the camera of a cell */
+	FVector GetViewDirection(int32 CellX, int32 CellY) const;
+
+	/** @return name of the buffer visualization drawn into a layer, None for the lit color and the depth drawn by a post process material */
+	static FName GetBufferVisualizationMode(EThumbnailImpostorLayer Layer);
+
+	/**
+	 * Octahedral mapping between unit directions, Z up, and [0, 1] coordinates, as done by the impostor materials.
+	 * The hemisphere mapping is the octahedron turned by 45 degrees, the horizon is the border of the square.
+	 */
+	static FVector OctahedronToDirection(const FVector2D& UV, bool bFullSphere);
+	static FVector2D DirectionToOctahedron(const FVector& Direction, bool bFullSphere);
+
+	/**
+	 * Filters a render of RenderSize down by Factor and writes the atlas, GetAtlasSize(RenderSize / Factor), to AtlasPixels.
+	 * Only the color layer is keyed, a normal or a depth could match the key color. The normal and depth layers are plainly averaged,
+	 * their render alpha isn't coverage and weighting by it would zero or skew them.
+	 */
+	void BuildAtlas(TArrayView<const FColor> RenderPixels, FIntPoint RenderSize, int32 Factor, EThumbnailBackgroundMode Mode, const FThumbnailKeyingParams& Params, FColor* AtlasPixels) const;
+
+	/**
+	 * Records the layout on an atlas texture as a UThumbnailImpostorUserData, read back with ReadFromTexture().
+	 * The user data is cooked with the texture, so games can read it at runtime through the ThumbnailToTextureRuntime module.
+	 */
+	void WriteToTexture(UTexture2D* Texture) const;
+
+	/** @return false if the texture isn't an impostor atlas, OutLayout then has no grid */
+	static bool ReadFromTexture(const UTexture2D* Texture, FThumbnailImpostorLayout& OutLayout);
+};
@@ -0,0 +1,39 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IO/IoHash.h"
+
+struct FAssetData;
+struct FThumbnailToTextureSettingsSnapshot;
+
+/**
+ * Hashes everything the thumbnail texture of an asset is made from, used to skip unchanged assets and as derived data key.
+ *
+ * The inputs are the saved hash of the asset's package and of every package it hard references (materials, textures...),
+ * the default orbit of USceneThumbnailInfo, the background and resolution settings, and whether the thumbnail is rendered
+ * or copied from the package. Rendered thumbnails also hash the saved package of the background material they are drawn with,
+ * along with its own dependencies, and the keying parameters read from it.
+ * An asset's own thumbnail info is saved in its package, so it is covered by the package hash.
+ */
+class THUMBNAILTOTEXTURETOOL_API FThumbnailInputHasher
+{
+public:
+	/**
+	 * Hashes the inputs of the thumbnail of AssetData.
+	 * Returns false when some input only exists in memory, in a dirty package, the result of the export must then not be reused.
+	 */
+	bool ComputeInputHash(const FAssetData& AssetData, bool bRendered, const FThumbnailToTextureSettingsSnapshot& Settings, FString& OutInputHash);
+
+private:
+	/** Collects the saved hashes of a package and of all the packages it hard references, false if one is dirty */
+	bool GatherPackageHashes(FName PackageName, TArray<TPair<FName, FIoHash>>& OutPackageHashes);
+
+	/** @return saved hash of a package, zero for packages without one such as script packages */
+	FIoHash GetPackageSavedHash(FName PackageName);
+
+	/** Asset registry lookups, shared by the assets of a run since they often use the same materials and textures */
+	TMap<FName, FIoHash> PackageSavedHashes;
+	TMap<FName, TArray<FName>> PackageDependencies;
+};
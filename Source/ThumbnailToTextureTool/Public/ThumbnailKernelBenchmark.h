@@ -0,0 +1,34 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Throughput of a CPU pixel kernel of ThumbnailImageUtils, compared to the code it replaced when there is one
+ */
+struct FThumbnailKernelBenchmarkResult
+{
+	FString Name;
+
+	/** Source pixels processed per second, averaged over the iterations */
+	double PixelsPerSecond = 0.0;
+
+	/** Same for the former implementation or a per pixel reference, 0 if the kernel has none */
+	double ReferencePixelsPerSecond = 0.0;
+
+	/** False if the kernel's output differs from the reference */
+	bool bMatchesReference = true;
+};
+
+/**
+ * Microbenchmarks of the CPU pixel kernels on synthetic thumbnails.
+ * Can be run from the editor console with ThumbnailToTexture.BenchmarkKernels [NumPixels] [NumIterations].
+ */
+namespace ThumbnailKernelBenchmark
+{
+	THUMBNAILTOTEXTURETOOL_API TArray<FThumbnailKernelBenchmarkResult> Run(int32 NumPixels, int32 NumIterations);
+
+	/** Prints the results to LogThumbnailToTexture */
+	THUMBNAILTOTEXTURETOOL_API void LogResults(const TArray<FThumbnailKernelBenchmarkResult>& Results);
+}
@@ -0,0 +1,98 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FRHIGPUTextureReadback;
+class FTextureRenderTargetResource;
+class UTextureRenderTarget2D;
+
+/**
+ * Pixels of a thumbnail render copied back from the GPU
+ */
+struct FThumbnailReadback
+{
+	/** Id given to FThumbnailReadbackRing::EndRender() */
+	int32 RequestId = INDEX_NONE;
+
+	int32 Width = 0;
+	int32 Height = 0;
+
+	/** Gamma space pixels, top row first */
+	TArray<FColor> Pixels;
+};
+
+/**
+ * Area of a render read back as its own thumbnail, used when several thumbnails are drawn into one render target
+ */
+struct FThumbnailReadbackTile
+{
+	/** Id handed back with the pixels of the tile */
+	int32 RequestId = INDEX_NONE;
+
+	/** Area of the render target covered by the thumbnail */
+	FIntRect Rect;
+};
+
+/**
+ * Ring of renders whose content is copied back to the CPU asynchronously.
+ * Render targets come from the module's FThumbnailRenderTargetPool and go back to it once read back.
+ * While the pixels of thumbnail K are copied back, thumbnail K+1 can be drawn into the next slot,
+ * so neither the game thread nor the GPU waits on the other for every asset.
+ * Readbacks are always returned in submission order.
+ */
+class THUMBNAILTOTEXTURETOOL_API FThumbnailReadbackRing
+{
+public:
+	FThumbnailReadbackRing(int32 InNumSlots, FIntPoint InSize);
+	~FThumbnailReadbackRing();
+
+	FThumbnailReadbackRing(const FThumbnailReadbackRing&) = delete;
+	FThumbnailReadbackRing& operator=(const FThumbnailReadbackRing&) = delete;
+
+	/**
+	 * Returns the render target to draw the next thumbnail into.
+	 * If every slot is in flight, waits for the oldest readback and appends it to OutCompleted.
+	 */
+	FTextureRenderTargetResource* BeginRender(TArray<FThumbnailReadback>& OutCompleted);
+
+	/** Queues the GPU copy of the render target returned by the last BeginRender(), RequestId is handed back with its pixels */
+	void EndRender(int32 RequestId);
+
+	/** Same as EndRender(int32) when the render target holds several thumbnails, each tile is returned as its own readback */
+	void EndRender(TArrayView<const FThumbnailReadbackTile> Tiles);
+
+	/** Appends the readbacks the GPU already finished to OutCompleted, in submission order, without waiting */
+	void PollCompleted(TArray<FThumbnailReadback>& OutCompleted);
+
+	/** Waits for every readback in flight and appends them to OutCompleted */
+	void Flush(TArray<FThumbnailReadback>& OutCompleted);
+
+	/** @return number of renders whose pixels haven't been returned yet, a render may hold several tiles */
+	int32 GetNumInFlight() const { return NumInFlight; }
+
+	FIntPoint GetSize() const { return Size; }
+
+private:
+	struct FSlot
+	{
+		/** Acquired from the pool between BeginRender() and the end of the readback */
+		UTextureRenderTarget2D* RenderTarget = nullptr;
+		TUniquePtr<FRHIGPUTextureReadback> Readback;
+		TArray<FThumbnailReadbackTile> Tiles;
+	};
+
+	/** Copies the pixels of the oldest slot's tiles to OutCompleted and frees it, waits for the GPU if bWait */
+	bool CompleteOldest(TArray<FThumbnailReadback>& OutCompleted, bool bWait);
+
+	TArray<FSlot> Slots;
+	FIntPoint Size;
+
+	/** Slot of the oldest readback in flight */
+	int32 OldestSlot;
+	int32 NumInFlight;
+
+	/** True between BeginRender() and EndRender() */
+	bool bRendering;
+};
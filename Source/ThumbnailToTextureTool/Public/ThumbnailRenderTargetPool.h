@@ -0,0 +1,72 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UTextureRenderTarget2D;
+
+/**
+ * Counters of FThumbnailRenderTargetPool, since the pool was created
+ */
+struct FThumbnailRenderTargetPoolStats
+{
+	/** Acquires served by a pooled render target */
+	int32 NumHits = 0;
+
+	/** Acquires that had to allocate a new render target */
+	int32 NumMisses = 0;
+
+	/** Render targets released while the pool was full, their GPU memory was freed */
+	int32 NumDiscarded = 0;
+
+	/** Render targets currently waiting in the pool */
+	int32 NumPooled = 0;
+};
+
+/**
+ * Render targets used to draw thumbnails, reused across assets and export batches instead of allocating one per asset.
+ * Lives in the module, see IThumbnailToTextureToolModule::GetRenderTargetPool().
+ */
+class THUMBNAILTOTEXTURETOOL_API FThumbnailRenderTargetPool
+{
+public:
+	FThumbnailRenderTargetPool();
+	~FThumbnailRenderTargetPool();
+
+	FThumbnailRenderTargetPool(const FThumbnailRenderTargetPool&) = delete;
+	FThumbnailRenderTargetPool& operator=(const FThumbnailRenderTargetPool&) = delete;
+
+	/** Returns a render target of the given size and format, cleared to its clear color */
+	UTextureRenderTarget2D* Acquire(FIntPoint Size, EPixelFormat Format);
+
+	/** Gives a render target back to the pool once nothing reads from it anymore. Frees it if the pool is full */
+	void Release(UTextureRenderTarget2D* RenderTarget);
+
+	/** Frees every pooled render target */
+	void Empty();
+
+	/** Maximum number of render targets kept in the pool, the extra ones are freed when released */
+	void SetMaxPooledRenderTargets(int32 InMaxPooledRenderTargets);
+
+	const FThumbnailRenderTargetPoolStats& GetStats() const { return Stats; }
+
+private:
+	/** Frees the GPU resource of a render target and lets it be garbage collected */
+	static void DestroyRenderTarget(UTextureRenderTarget2D* RenderTarget);
+
+	struct FPoolKey
+	{
+		FIntPoint Size;
+		EPixelFormat Format;
+
+		bool operator==(const FPoolKey& Other) const { return Size == Other.Size && Format == Other.Format; }
+		friend uint32 GetTypeHash(const FPoolKey& Key) { return HashCombine(GetTypeHash(Key.Size), GetTypeHash(Key.Format)); }
+	};
+
+	/** Render targets waiting to be acquired again, by size and format */
+	TMap<FPoolKey, TArray<UTextureRenderTarget2D*>> PooledRenderTargets;
+
+	FThumbnailRenderTargetPoolStats Stats;
+	int32 MaxPooledRenderTargets;
+};
@@ -0,0 +1,124 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class FCustomThumbnailPreviewScene;
+
+/**
+ * Counters of FThumbnailSceneCache, since the cache was created
+ */
+struct FThumbnailSceneCacheStats
+{
+	/** Lookups served by a cached scene */
+	int32 NumHits = 0;
+
+	/** Lookups that had to create a new scene */
+	int32 NumMisses = 0;
+
+	/** Scenes freed to stay within the budget or MaxScenes */
+	int32 NumEvictions = 0;
+
+	/** Scenes currently cached */
+	int32 NumScenes = 0;
+
+	/** Estimated size of the objects of the cached scenes, see FThumbnailSceneCache::EstimateSceneSize() */
+	int64 EstimatedSizeBytes = 0;
+};
+
+/**
+ * Preview scenes kept per asset or class by the custom renderers, shared by all of them.
+ * Only serves the renderers' Draw(), which the engine calls for one thumbnail at a time. Exports draw their batches in each renderer's own scene, see DrawBatch().
+ * The least recently used scenes are freed once the estimated size of their objects goes over the budget, or once there are more than MaxScenes.
+ * The budget doesn't bound the memory of the scenes, the renderer's FScene and GPU buffers of each one can't be measured from here.
+ * A renderer may empty its scene after drawing, so a scene can be measured much smaller than it was while drawn, MaxScenes bounds those.
+ * Each renderer passes itself as the owner of its scenes, so a scene is always handed back to the renderer that created it, with its type.
+ * Lives in the module, see IThumbnailToTextureToolModule::GetPreviewSceneCache().
+ */
+class THUMBNAILTOTEXTURETOOL_API FThumbnailSceneCache
+{
+public:
+	FThumbnailSceneCache();
+	~FThumbnailSceneCache();
+
+	FThumbnailSceneCache(const FThumbnailSceneCache&) = delete;
+	FThumbnailSceneCache& operator=(const FThumbnailSceneCache&) = delete;
+
+	/** Returns the scene of Object, creating it if it isn't cached. The scene becomes the most recently used one */
+	template<typename SceneType>
+	TSharedRef<SceneType> FindOrCreate(const void* Owner, const UObject* Object)
+	{
+		static_assert(TIsDerivedFrom<SceneType, FCustomThumbnailPreviewScene>::Value, "Only preview scenes of the plugin can be cached");
+		return StaticCastSharedRef<SceneType>(FindOrAdd(FSceneKey{Owner, FObjectKey(Object)}, []() -> TSharedRef<FCustomThumbnailPreviewScene>
+		{
+			return MakeShared<SceneType>();
+		}));
+	}
+
+	/** @return the scene of Object if it is cached, doesn't count as a use */
+	template<typename SceneType>
+	TSharedPtr<SceneType> Find(const void* Owner, const UObject* Object) const
+	{
+		if (const FEntry* Entry = Entries.Find(FSceneKey{Owner, FObjectKey(Object)}))
+		{
+			return StaticCastSharedRef<SceneType>(Entry->Scene);
+		}
+		return nullptr;
+	}
+
+	/** Frees the scene of Object */
+	void Remove(const void* Owner, const UObject* Object);
+
+	/** Frees every scene created by Owner */
+	void RemoveAll(const void* Owner);
+
+	/** Frees every scene */
+	void Empty();
+
+	/** Estimated size of the objects of the cached scenes above which the least recently used ones are freed */
+	void SetBudgetBytes(int64 InBudgetBytes);
+
+	const FThumbnailSceneCacheStats& GetStats() const { return Stats; }
+
+	/** Most scenes kept whatever their estimated size, same as the engine's TObjectInstanceThumbnailScene */
+	static constexpr int32 MaxScenes = 128;
+
+private:
+	struct FSceneKey
+	{
+		const void* Owner;
+		FObjectKey Object;
+
+		bool operator==(const FSceneKey& Other) const { return Owner == Other.Owner && Object == Other.Object; }
+		friend uint32 GetTypeHash(const FSceneKey& Key) { return HashCombine(PointerHash(Key.Owner), GetTypeHash(Key.Object)); }
+	};
+
+	struct FEntry
+	{
+		TSharedRef<FCustomThumbnailPreviewScene> Scene;
+
+		/** Value of UseCounter when the scene was last returned */
+		uint64 LastUse = 0;
+
+		/** INDEX_NONE until the scene was populated, see Trim() */
+		int64 EstimatedSizeBytes = INDEX_NONE;
+	};
+
+	TSharedRef<FCustomThumbnailPreviewScene> FindOrAdd(const FSceneKey& Key, TFunctionRef<TSharedRef<FCustomThumbnailPreviewScene>()> CreateScene);
+
+	/**
+	 * Measures the scenes that weren't yet, then frees the least recently used ones until the cache fits in MaxSizeBytes and MaxNumScenes.
+	 * Scenes are measured on the lookup following their creation, once their renderer drew with them.
+	 */
+	void Trim(int64 MaxSizeBytes, int32 MaxNumScenes);
+
+	/** @return estimated memory of the objects of a scene's world, the rendering thread's copy of the scene isn't counted */
+	static int64 EstimateSceneSize(const FCustomThumbnailPreviewScene& Scene);
+
+	TMap<FSceneKey, FEntry> Entries;
+	FThumbnailSceneCacheStats Stats;
+	int64 BudgetBytes;
+	uint64 UseCounter;
+};
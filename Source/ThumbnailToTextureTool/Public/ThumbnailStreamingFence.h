@@ -0,0 +1,49 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UPrimitiveComponent;
+class UStreamableRenderAsset;
+
+/**
+ * Outcome of FThumbnailStreamingFence::Wait()
+ */
+struct FThumbnailStreamingWaitResult
+{
+	/** Time spent waiting for the mips to become resident, in seconds */
+	double WaitSeconds = 0.0;
+
+	/** Textures and meshes used by the render */
+	int32 NumAssets = 0;
+
+	/** Assets still streaming when the render went ahead */
+	int32 NumPendingAssets = 0;
+
+	/** True if the wait gave up with some assets not fully resident, never set when not waiting at all */
+	bool bTimedOut = false;
+};
+
+/**
+ * Makes the textures and meshes drawn by a thumbnail render fully resident before it is drawn.
+ * The preview scenes only tell the streamer about their views, so a render right after swapping the assets
+ * would capture whatever low mips happened to be loaded. The fence forces every mip of the gathered assets resident
+ * for a little longer than the wait, then ticks the streamer until they're in or the timeout is reached.
+ */
+class THUMBNAILTOTEXTURETOOL_API FThumbnailStreamingFence
+{
+public:
+	/** Gathers the textures used by the materials of Components and the meshes they draw */
+	void AddComponents(TArrayView<const UPrimitiveComponent* const> Components);
+
+	/** Waits at most TimeoutSeconds for every gathered asset to be fully streamed in, 0 only forces them resident */
+	FThumbnailStreamingWaitResult Wait(double TimeoutSeconds);
+
+private:
+	/** @return number of gathered assets not fully streamed in yet */
+	int32 GetNumPendingAssets() const;
+
+	TArray<TWeakObjectPtr<UStreamableRenderAsset>> Assets;
+};
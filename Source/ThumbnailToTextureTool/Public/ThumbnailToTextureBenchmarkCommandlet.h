@@ -0,0 +1,85 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ThumbnailToTextureBenchmarkCommandlet.generated.h"
+
+class FJsonObject;
+class UBlueprint;
+class UStaticMesh;
+struct FAssetData;
+
+/**
+ * Measures the export throughput on synthetic content, for tracking the performance of the plugin across versions.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd.exe <Project> -run=ThumbnailToTextureBenchmark -AllowCommandletRendering
+ *                        [-KernelsOnly] [-NumPixels=1048576] [-Iterations=20] [-ContainerEntries=20000] [-ContainerLookups=1000000]
+ *                        [-NumStaticMeshes=64] [-NumBlueprints=32] [-MaxComponents=8] [-ContentPath=/Game/Props]
+ *                        [-Modes=Cached+CustomMaterial+Transparent+Impostor] [-ImpostorGridSize=8] [-OutputFormat=PNG]
+ *                        [-UseDDC] [-KeepContent] [-Output=<File>]
+ *
+ *   -KernelsOnly     Only run the CPU pixel kernels and the container benchmark, no content is created and nothing is rendered. Works with -nullrhi
+ *   -NumPixels       Pixels processed by each kernel iteration
+ *   -Iterations      Iterations of each kernel
+ *   -ContainerEntries Thumbnails written to the synthetic container whose open time and lookup latency are measured
+ *   -ContainerLookups Random lookups timed in that container
+ *   -NumStaticMeshes Procedural spheres of increasing triangle counts
+ *   -NumBlueprints   Actor blueprints with 1 to MaxComponents static mesh components
+ *   -ContentPath     Export the static meshes and blueprints of this folder and its subfolders instead of synthetic content
+ *   -Modes           Background modes to export with, Cached exports the thumbnails saved in the packages
+ *                    and Impostor exports octahedral impostor atlases with a transparent background
+ *   -ImpostorGridSize Views per side of the impostor atlases of the Impostor mode
+ *   -OutputFormat    Texture2D, PNG, JPEG, EXR or Container, the other formats write files instead of texture packages
+ *   -UseDDC          Let the exports use the Derived Data Cache, by default every thumbnail is rendered
+ *   -KeepContent     Don't delete the synthetic assets and exported textures, in /Game/ThumbnailToTextureBenchmark
+ *                    The assets of -ContentPath are never deleted, only the textures exported from them
+ *   -Output          JSON results, Saved/ThumbnailToTexture/Benchmark.json by default
+ *
+ * The results hold the plugin and engine versions, the machine, the kernel throughputs, the container open time and lookup latency and, for each mode,
+ * the export throughput, the views rendered per second, the time and items of each stat phase and the memory the export added.
+ *
+ * Returns 0 when every export succeeded and the kernels match their reference, 1 otherwise.
+ */
+UCLASS()
+class THUMBNAILTOTEXTURETOOL_API UThumbnailToTextureBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UThumbnailToTextureBenchmarkCommandlet();
+
+	// Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	// End UCommandlet Interface
+
+private:
+	/** Finds the static meshes and blueprints under ContentPath, @return false if there are none */
+	static bool GatherContent(const FString& ContentPath, TArray<FAssetData>& OutAssets);
+
+	/** Creates and saves the synthetic assets to export */
+	static bool CreateContent(int32 NumStaticMeshes, int32 NumBlueprints, int32 MaxComponents, TArray<FAssetData>& OutAssets);
+
+	/** @return UV sphere with NumSegments around and NumSegments / 2 rings */
+	static UStaticMesh* CreateStaticMesh(const FString& PackageName, int32 NumSegments);
+
+	/** @return actor blueprint with NumComponents static mesh components laid out on a line */
+	static UBlueprint* CreateBlueprint(const FString& PackageName, TArrayView<UStaticMesh* const> StaticMeshes, int32 NumComponents);
+
+	/** Generates the thumbnail of Asset and saves its package */
+	static bool SaveAsset(UObject* Asset);
+
+	/** Deletes the synthetic assets and the exported textures from disk */
+	static void DeleteContent();
+
+	/**
+	 * Writes a container of NumEntries small BGRA8 thumbnails, then times opening it and NumLookups random lookups.
+	 * bOutValid is false if a lookup missed or found the wrong thumbnail
+	 */
+	static TSharedRef<FJsonObject> BenchmarkContainer(int32 NumEntries, int32 NumLookups, bool bKeepContainer, bool& bOutValid);
+
+	/** Machine, engine and plugin the benchmark runs on */
+	static TSharedRef<FJsonObject> DescribeEnvironment();
+};
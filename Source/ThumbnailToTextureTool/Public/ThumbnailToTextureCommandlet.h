@@ -0,0 +1,50 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ThumbnailToTextureCommandlet.generated.h"
+
+struct FAssetData;
+
+/**
+ * Exports asset thumbnails to textures without an interactive editor, for build machines.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd.exe <Project> -run=ThumbnailToTexture [-Paths=/Game/A+/Game/B] [-Assets=/Game/A/SM_Rock.SM_Rock+...]
+ *                        [-Classes=StaticMesh+Blueprint] [-Manifest=<File>] [-CachedOnly] [-nullrhi]
+ *                        [-Full] [-ExportManifest=<File>] [-NoDDC]
+ *
+ *   -Paths     Content folders to export, searched recursively
+ *   -Assets    Object paths of single assets to export
+ *   -Classes   Only export assets of these classes, by short name or full path
+ *   -Manifest  Text file with one object path or content folder per line, lines starting with # are ignored
+ *   -CachedOnly Never render, use the thumbnails saved in the packages. Implied by -nullrhi
+ *   -Full      Export every asset, by default the assets that didn't change since their last export are skipped
+ *   -ExportManifest Where the inputs of the exported assets are recorded, Saved/ThumbnailToTexture/ExportManifest.json by default
+ *   -NoDDC     Render every thumbnail instead of fetching the ones already in the Derived Data Cache, and don't store them
+ *
+ * Commandlets don't render unless -AllowCommandletRendering is passed, without it the cached thumbnails are exported.
+ *
+ * Returns 0 when every asset was exported, 1 otherwise.
+ */
+UCLASS()
+class THUMBNAILTOTEXTURETOOL_API UThumbnailToTextureCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UThumbnailToTextureCommandlet();
+
+	// Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	// End UCommandlet Interface
+
+private:
+	/** Gathers the assets to export from the command line, false if the command line is invalid */
+	bool GatherAssets(const TMap<FString, FString>& ParamVals, TArray<FAssetData>& OutAssets) const;
+
+	/** Reads the object paths and content folders listed in a manifest file */
+	static bool ReadManifest(const FString& ManifestFilename, TArray<FString>& OutAssetPaths, TArray<FString>& OutFolderPaths);
+};
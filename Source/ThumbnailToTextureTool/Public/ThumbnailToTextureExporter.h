@@ -0,0 +1,412 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ThumbnailBulkReader.h"
+#include "ThumbnailImpostorLayout.h"
+#include "ThumbnailInputHasher.h"
+#include "ThumbnailRenderTargetPool.h"
+#include "ThumbnailToTextureSettings.h"
+#include "ThumbnailTurntableLayout.h"
+#include "AssetRegistry/AssetData.h"
+#include "Tasks/Task.h"
+#include "UObject/StrongObjectPtr.h"
+
+class FThumbnailContainerWriter;
+class FThumbnailExportManifest;
+class FThumbnailReadbackRing;
+class UMaterialInterface;
+class UPackage;
+class UTexture2D;
+class UThumbnailRenderer;
+struct FThumbnailReadback;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogThumbnailToTexture, Log, All);
+
+/**
+ * Results of an export run, filled by FThumbnailToTextureExporter
+ */
+struct THUMBNAILTOTEXTURETOOL_API FThumbnailExportStats
+{
+	/** Number of assets handed to the exporter */
+	int32 NumRequested = 0;
+
+	/** Number of textures, or image files, successfully created */
+	int32 NumExported = 0;
+
+	/** Number of the exported textures that were rendered, the others were fetched from the Derived Data Cache or copied from the thumbnail cached in the package */
+	int32 NumRendered = 0;
+
+	/** Number of assets skipped because they didn't change since their last export, see FThumbnailExportManifest */
+	int32 NumSkipped = 0;
+
+	/** Number of assets that were supported but could not be exported */
+	int32 NumFailed = 0;
+
+	/** Number of assets skipped because their class isn't supported */
+	int32 NumUnsupported = 0;
+
+	/** Total time spent in the export, in seconds */
+	double WallTimeSeconds = 0.0;
+
+	/** Time spent rendering or reading the thumbnails and filling the textures, in seconds */
+	double ExportTimeSeconds = 0.0;
+
+	/** Time spent waiting for the textures still compiling once every thumbnail was exported, in seconds */
+	double TextureCompileWaitSeconds = 0.0;
+
+	/** Time spent checking out and saving the texture packages, or waiting for the image files to be written, at the end of the batch, in seconds */
+	double SaveTimeSeconds = 0.0;
+
+	/** Textures whose compilation finished while the next thumbnails were exported, and textures still compiling at the end */
+	int32 NumTexturesCompiledInBackground = 0;
+	int32 NumTexturesCompiledAtEnd = 0;
+
+	/** Render targets reused from, or allocated by, the module's render target pool during the run */
+	int32 NumRenderTargetPoolHits = 0;
+	int32 NumRenderTargetPoolMisses = 0;
+
+	/** Rendered thumbnails found in, or missing from, the Derived Data Cache, see ThumbnailDerivedData */
+	int32 NumDerivedDataCacheHits = 0;
+	int32 NumDerivedDataCacheMisses = 0;
+
+	/** Assets whose render was put off until the shaders of their materials were compiled, the ready assets were drawn in the meantime */
+	int32 NumShaderCompileDeferrals = 0;
+
+	/** Time the renders spent waiting for their textures and meshes to stream in, in seconds, see FThumbnailStreamingFence */
+	double StreamingWaitSeconds = 0.0;
+
+	/** Assets rendered with some of their textures or meshes still streaming because the wait timed out */
+	int32 NumStreamingTimeouts = 0;
+
+	/** Object paths of the assets that failed to export */
+	TArray<FString> FailedAssets;
+
+	/** @return exported assets per second of wall time */
+	double GetAssetsPerSecond() const;
+
+	/** Prints the summary of the run to LogThumbnailToTexture */
+	void LogSummary() const;
+};
+
+/**
+ * Outcome of FThumbnailToTextureExporter::ExportAsset()
+ */
+enum class EThumbnailExportResult : uint8
+{
+	/** The thumbnail was rendered, the texture is filled once its pixels are read back */
+	Rendered,
+
+	/** The thumbnail cached in the asset's package is copied, once read along with the other queued assets */
+	Cached,
+
+	/** The thumbnail was rendered before, its pixels were fetched from the Derived Data Cache */
+	DerivedDataCache,
+
+	/** Nothing changed since the last export, see FThumbnailToTextureExporter::EnableIncrementalExport() */
+	Skipped,
+
+	Failed
+};
+
+/**
+ * Exports the thumbnail of assets to UTexture2D packages in the directory defined in UThumbnailToTextureSettings,
+ * or to image files or a single container when UThumbnailToTextureSettings::OutputFormat says so.
+ * Shared by the Content Browser menu and UThumbnailToTextureCommandlet.
+ * The preview scenes of the custom renderers stay populated from BeginExport() to FinishExport() or CancelPendingExports(),
+ * see UCustomStaticMeshThumbnailRenderer::BeginPersistentScene().
+ */
+class THUMBNAILTOTEXTURETOOL_API FThumbnailToTextureExporter
+{
+public:
+	FThumbnailToTextureExporter();
+	~FThumbnailToTextureExporter();
+
+	/** Returns whether the exporter supports the given asset class */
+	static bool DoesAssetSupportExportToThumbnail(const FAssetData& AssetData);
+
+	/** If true, never render the thumbnail and always use the one cached in the asset's package. Forced on when the RHI can't render */
+	void SetForceCachedThumbnails(bool bInForceCachedThumbnails) { bForceCachedThumbnails = bInForceCachedThumbnails; }
+
+	/** If false, never use the Derived Data Cache even if UThumbnailToTextureSettings::UseDerivedDataCache is set */
+	void SetUseDerivedDataCache(bool bInUseDerivedDataCache) { bUseDerivedDataCache = bInUseDerivedDataCache; }
+
+	/**
+	 * Skips the assets whose thumbnail inputs didn't change since they were last exported, as recorded in the given manifest file.
+	 * The manifest is updated when the packages are saved.
+	 */
+	void EnableIncrementalExport(const FString& ManifestFilename);
+
+	/** Exports every supported asset of the list then saves all created packages, unsupported assets are counted and skipped */
+	FThumbnailExportStats ExportAssets(const TArray<FAssetData>& Assets);
+
+	/**
+	 * Same as ExportAssets() spread over several calls, for callers that can't block such as FThumbnailExportTask.
+	 * BeginExport() resets OutStats, each asset is then handed to ExportAsset(AssetData, Stats) and FinishExport() saves the packages.
+	 */
+	void BeginExport(int32 NumAssets, FThumbnailExportStats& OutStats);
+	void ExportAsset(const FAssetData& AssetData, FThumbnailExportStats& InOutStats);
+	void FinishExport(FThumbnailExportStats& InOutStats);
+
+	/** Throws away every texture created since the last SavePendingPackages(), queued, rendering or waiting to be saved. Nothing is written */
+	void CancelPendingExports();
+
+	/**
+	 * Assets whose materials still have shaders compiling are not drawn right away, they would show the default material.
+	 * Their compilation is moved up the queue and they are drawn once it's done, the other assets are drawn in the meantime.
+	 * @return number of assets waiting for their shaders
+	 */
+	int32 GetNumDeferredRenders() const { return DeferredRenders.Num(); }
+
+	/** Queues the deferred assets whose shaders are now compiled for drawing, doesn't wait for the others */
+	void UpdateDeferredRenders();
+
+	/**
+	 * Exports a single asset.
+	 * The texture package isn't saved until SavePendingPackages() is called.
+	 */
+	EThumbnailExportResult ExportAsset(const FAssetData& AssetData);
+
+	/**
+	 * Checks out all the packages created since the last call in one source control operation and saves them concurrently,
+	 * and waits for the image files still being written.
+	 * Assets whose cached thumbnail couldn't be read or whose package or file couldn't be saved are moved from NumExported to NumFailed in OutStats.
+	 */
+	void SavePendingPackages(FThumbnailExportStats& OutStats);
+
+private:
+	/** Renderer drawing the assets of a batch, only the custom renderers can draw several assets at once */
+	enum class EBatchRenderer : uint8
+	{
+		None,
+		StaticMesh,
+		Blueprint,
+		Other
+	};
+
+	/** Keeps the preview scenes of the custom renderers populated between batches, until EndPersistentScenes() */
+	void BeginPersistentScenes();
+	void EndPersistentScenes();
+
+	/** Whether the pixels are written to image files or a container instead of texture packages */
+	bool IsExportingImages() const { return Settings->OutputFormat != EThumbnailOutputFormat::Texture2D; }
+
+	/** Whether thumbnails are rendered with the custom renderers or copied from the packages */
+	bool ShouldRenderThumbnails() const;
+
+	/** Builds the name and package of the texture that will hold the thumbnail of AssetData */
+	bool GetTexturePackageName(const FAssetData& AssetData, FString& OutPackageName, FString& OutAssetName) const;
+
+	/** @return absolute filename of the image holding the thumbnail of AssetData, under the same folders as the asset */
+	FString GetImageFilename(const FAssetData& AssetData, const FString& AssetName) const;
+
+	/**
+	 * Queues the asset to be drawn with the custom renderers, false if the asset has no rendering info.
+	 * Assets drawn by the same renderer are batched together, see FlushBatch().
+	 */
+	bool BeginRenderedThumbnail(const FAssetData& AssetData, int32 RequestId);
+
+	/** Adds the asset to the pending batch, flushing it first if the asset can't be drawn along with it */
+	void QueueBatchItem(UObject* Object, int32 RequestId, EBatchRenderer BatchRenderer, UThumbnailRenderer* OtherRenderer);
+
+	/** Draws the queued batch into the tiles of one render target and queues the readback of its pixels */
+	void FlushBatch();
+
+	/** Waits for the shaders of every deferred asset and queues them, for when nothing else is left to draw */
+	void FinishDeferredRenders();
+
+	/** Hands the readbacks finished by the GPU to FinishRenderedThumbnail(), draws the queued batch and waits for all of them if bWaitForAll */
+	void PollReadbacks(bool bWaitForAll);
+
+	/** Fills the textures of the completed readbacks and queues their packages for saving, or queues their image files */
+	void ProcessCompletedReadbacks(TArray<FThumbnailReadback>& Completed);
+
+	/** Whether the rendered thumbnails are stored in and fetched from the Derived Data Cache */
+	bool ShouldUseDerivedDataCache() const;
+
+	/** @return size of the texture or image exported from a readback */
+	FIntPoint GetExportedSize(const FThumbnailReadback& Readback) const;
+
+	/** Keys the background of the read back pixels if needed and filters them down, or builds the impostor atlas, to GetExportedSize() pixels */
+	void KeyRenderedPixels(const FThumbnailReadback& Readback, FColor* OutPixels) const;
+
+	/** Fills NewTexture with the read back pixels, keying the background if needed, and stores them under DerivedDataKey if not empty */
+	void FinishRenderedThumbnail(FThumbnailReadback& Readback, UTexture2D* NewTexture, const FString& DerivedDataKey);
+
+	/** Waits for the textures of the pending packages still compiling asynchronously */
+	void FinishTextureCompilation(FThumbnailExportStats& OutStats);
+
+	/** Texture settings of rendered thumbnails, once the source is filled, along with their turntable layout */
+	void ApplyRenderedTextureSettings(UTexture2D* NewTexture) const;
+
+	/**
+	 * Replaces the single mip source of a texture with its full mip chain when Settings->bGenerateMipsOnCPU is set.
+	 * bAlphaWeighted when the alpha of the source is the coverage left by keying, see ThumbnailImageUtils::BuildMipChain()
+	 * @return false if the texture keeps a single mip, its size isn't a power of two or the setting is off
+	 */
+	bool BuildSourceMips(UTexture2D* NewTexture, bool bAlphaWeighted) const;
+
+	/** Reads the queued cached thumbnails in one parallel pass and fills their textures */
+	void FlushCachedThumbnails();
+
+	/** Fills NewTexture with a thumbnail saved in a package */
+	void FillCachedThumbnailTexture(const FObjectThumbnail& Thumbnail, UTexture2D* NewTexture) const;
+
+	/** Waits for the image files being written and commits the container, records them in the manifest and counts the ones that failed */
+	void FinishImageWrites(FThumbnailExportStats& OutStats);
+
+	/**
+	 * A texture created by ExportAsset() and waiting to be saved, RF_Standalone keeps it alive until then.
+	 * When exporting image files nothing is created, Package and Texture are null and ImageFilename is written instead,
+	 * ImageFilename is the container when exporting to one.
+	 */
+	struct FPendingPackage
+	{
+		UPackage* Package = nullptr;
+		UTexture2D* Texture = nullptr;
+		FString SourceAssetPath;
+
+		/** Recorded in the manifest once saved, empty if the export can't be skipped next time */
+		FString InputHash;
+
+		/** The rendered pixels are stored under this key, empty if they aren't cached */
+		FString DerivedDataKey;
+
+		bool bRendered = false;
+
+		FString ImageFilename;
+
+		/** Encodes and writes ImageFilename, see WriteImage() */
+		UE::Tasks::TTask<bool> ImageWrite;
+	};
+
+	/** Fills the texture of Pending with the pixels stored under its DerivedDataKey, or writes them to its image file. False on a cache miss */
+	bool ExportDerivedDataThumbnail(FPendingPackage& Pending);
+
+	/** Keys the read back pixels like FinishRenderedThumbnail() and writes them to the image file of Pending */
+	void FinishRenderedImage(FThumbnailReadback& Readback, FPendingPackage&& Pending);
+
+	/** Writes a thumbnail saved in a package to the image file of Pending */
+	void WriteCachedThumbnailImage(const FObjectThumbnail& Thumbnail, FPendingPackage&& Pending);
+
+	/** Hands the pixels over to a worker that encodes and writes the image file of Pending, or adds them to the container, waits for older writes when too many are queued */
+	void WriteImage(FPendingPackage&& Pending, FIntPoint Size, TArray<FColor>&& Pixels);
+
+	/** @return the writer of Settings->ContainerFilename, opened on first use. Its thumbnails fail if the file can't be opened */
+	FThumbnailContainerWriter& GetContainerWriter();
+
+	/**
+	 * Removes a texture that won't be saved, along with its package if it was created by the export.
+	 * Packages that exist on disk had their texture replaced in memory, they are added to OutPackagesToRestore instead
+	 */
+	static void DiscardTexture(const FPendingPackage& Pending, TArray<UPackage*>& OutPackagesToRestore);
+
+	/** Loads back the saved textures of the packages, so the editor doesn't hold replaced textures it believes are clean */
+	static void RestorePackages(const TArray<UPackage*>& Packages);
+
+	/** Settings of the export, resolved when the exporter was created */
+	TSharedRef<const FThumbnailToTextureSettingsSnapshot> Settings;
+
+	/** Frames drawn in the tile of each asset, a single one unless exporting turntables */
+	FThumbnailTurntableLayout TurntableLayout;
+
+	/** Views drawn in the tile of each static mesh and blueprint when exporting impostors, the other assets export their cached thumbnail */
+	FThumbnailImpostorLayout ImpostorLayout;
+
+	/** Texture packages created since the last SavePendingPackages() */
+	TArray<FPendingPackage> PendingPackages;
+
+	/** Textures waiting for the pixels of their render, by readback request id */
+	TMap<int32, FPendingPackage> InFlightRenders;
+
+	/** Textures waiting for the thumbnail saved in their asset's package, see FlushCachedThumbnails() */
+	TArray<FPendingPackage> PendingCachedPackages;
+	TArray<FCachedThumbnailRead> PendingCachedReads;
+
+	/** Image files being encoded and written on the workers since the last SavePendingPackages(), the first NumImageWritesWaited are done */
+	TArray<FPendingPackage> PendingImageWrites;
+	int32 NumImageWritesWaited;
+
+	/**
+	 * Opened by the first thumbnail written to or skipped from the container, closed by SavePendingPackages() once its index is written
+	 * so the file can be read in between exports. The thumbnails not committed are rolled back.
+	 */
+	TUniquePtr<FThumbnailContainerWriter> ContainerWriter;
+
+	/** Assets reported as exported whose cached thumbnail couldn't be read, counted as failed by SavePendingPackages() */
+	TArray<FString> FailedCachedAssets;
+
+	struct FBatchItem
+	{
+		UObject* Object = nullptr;
+		int32 RequestId = INDEX_NONE;
+	};
+
+	/** Assets waiting to be drawn together */
+	TArray<FBatchItem> PendingBatch;
+	EBatchRenderer PendingBatchRenderer;
+
+	/** Engine renderer of the pending batch when it is EBatchRenderer::Other */
+	UThumbnailRenderer* PendingBatchOtherRenderer;
+
+	/** An asset put aside until the shaders of its materials are compiled, see GetNumDeferredRenders() */
+	struct FDeferredRender
+	{
+		/** Kept alive while it waits, the editor may collect garbage in between */
+		TStrongObjectPtr<UObject> Object;
+		int32 RequestId = INDEX_NONE;
+		EBatchRenderer BatchRenderer = EBatchRenderer::None;
+		UThumbnailRenderer* OtherRenderer = nullptr;
+
+		/** Materials that were still compiling when the asset was deferred */
+		TArray<TWeakObjectPtr<UMaterialInterface>> CompilingMaterials;
+	};
+
+	/** In the order the assets were exported */
+	TArray<FDeferredRender> DeferredRenders;
+
+	/** Number of tiles of the ring's render targets, fixed when the ring is created */
+	int32 BatchSize;
+
+	/** Size of the render of one thumbnail or turntable sheet, SupersampleFactor times the exported size */
+	FIntPoint TileSize;
+	int32 SupersampleFactor;
+
+	/** Set by EnableIncrementalExport() */
+	TUniquePtr<FThumbnailExportManifest> Manifest;
+
+	/** Hashes the inputs of the thumbnails for the manifest and the Derived Data Cache */
+	FThumbnailInputHasher InputHasher;
+
+	/** Derived Data Cache lookups since the exporter was created */
+	int32 NumDerivedDataCacheHits;
+	int32 NumDerivedDataCacheMisses;
+
+	/** Assets deferred until their shaders compiled since the exporter was created */
+	int32 NumShaderCompileDeferrals;
+
+	/** Streaming waits of the renders since the exporter was created */
+	double StreamingWaitSeconds;
+	int32 NumStreamingTimeouts;
+
+	/** Counters when BeginExport() was called, the stats of a run are the difference */
+	double ExportStartTime;
+	FThumbnailRenderTargetPoolStats StartPoolStats;
+	int32 StartDerivedDataCacheHits;
+	int32 StartDerivedDataCacheMisses;
+	int32 StartNumShaderCompileDeferrals;
+	double StartStreamingWaitSeconds;
+	int32 StartNumStreamingTimeouts;
+
+	/** Render targets being read back, created on the first render */
+	TUniquePtr<FThumbnailReadbackRing> ReadbackRing;
+
+	int32 NextRequestId;
+
+	bool bForceCachedThumbnails;
+	bool bUseDerivedDataCache;
+
+	/** In between BeginPersistentScenes() and EndPersistentScenes() */
+	bool bPersistentScenes;
+};
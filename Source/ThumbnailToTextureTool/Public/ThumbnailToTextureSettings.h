@@ -4,8 +4,79 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DeveloperSettings.h"
+#include "ThumbnailContainer.h"
+#include "ThumbnailImageUtils.h"
+#include "UObject/StrongObjectPtr.h"
 #include "ThumbnailToTextureSettings.generated.h"
 
+/**
+ * What an export writes for each asset
+ */
+UENUM()
+enum class EThumbnailOutputFormat : uint8
+{
+	/** A UTexture2D package in the Root Texture 2D Save Directory */
+	Texture2D,
+
+	/** Image files in the Image Output Directory, no package is created */
+	PNG,
+	JPEG,
+	EXR,
+
+	/** Every thumbnail appended to the single Container File, see FThumbnailContainerWriter */
+	Container
+};
+
+/**
+ * Settings of an export, resolved once from UThumbnailToTextureSettings so the export loop and the renderers don't look them up for every asset.
+ * Immutable, an export keeps the snapshot it started with even if the settings are edited while it runs.
+ * Built for each export job and never kept after it, it holds the background material loaded and a copy of its key color.
+ */
+struct THUMBNAILTOTEXTURETOOL_API FThumbnailToTextureSettingsSnapshot
+{
+	/** RootTexture2DSaveDir, always ending with a slash */
+	FString RootTexture2DSaveDir;
+	FString ThumbnailPrefix;
+
+	bool bUseCustomBackgroundMaterial = false;
+	bool bUseTransparentBackground = false;
+
+	/** UThumbnailToTextureSettings::GetBackgroundMaterial(), loaded */
+	TStrongObjectPtr<UMaterial> BackgroundMaterial;
+
+	/** Path of UThumbnailToTextureSettings::BackgroundMaterial, even when it isn't used */
+	FString BackgroundMaterialPath;
+
+	float BackgroundCutoffThreshold = 0.f;
+	int32 ThumbnailResolution = 0;
+	int32 SupersampleFactor = 1;
+
+	/** TurntableFrames, at least 1, and 1 when exporting impostors */
+	int32 NumTurntableFrames = 1;
+
+	/** ImpostorGridSize, 0 when exporting thumbnails */
+	int32 ImpostorGridSize = 0;
+	bool bImpostorFullSphere = false;
+	int32 NumReadbacksInFlight = 1;
+	int32 MaxBatchSize = 1;
+	bool bUseDerivedDataCache = false;
+	float StreamingWaitTimeoutSeconds = 0.f;
+	bool bGenerateMipsOnCPU = false;
+
+	EThumbnailOutputFormat OutputFormat = EThumbnailOutputFormat::Texture2D;
+
+	/** ImageOutputDirectory as an absolute path, always ending with a slash */
+	FString ImageOutputDir;
+
+	/** ContainerFile as an absolute path */
+	FString ContainerFilename;
+	EThumbnailContainerEntryFormat ContainerEntryFormat = EThumbnailContainerEntryFormat::PNG;
+
+	/** How the rendered thumbnails are keyed, the key color is read from the translucent material's Color parameter */
+	EThumbnailBackgroundMode BackgroundMode = EThumbnailBackgroundMode::Opaque;
+	FThumbnailKeyingParams KeyingParams;
+};
+
 /**
  * 
  */
@@ -42,8 +113,83 @@ public:
 	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, meta=(EditCondition="UseTransparentBackground"), Category = "Thumbnail To Texture Settings")
 	float BackgroundCutoffThreshold;
 
+	// Width and height in pixels of the exported textures, when the thumbnail is rendered
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, meta=(ClampMin=16, ClampMax=2048), Category = "Thumbnail To Texture Settings")
+	int32 ThumbnailResolution;
+
+	// Thumbnails are rendered this many times bigger in each direction then filtered down to the resolution, removing aliasing
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, meta=(ClampMin=1, ClampMax=4), Category = "Thumbnail To Texture Settings")
+	int32 SupersampleFactor;
+
+	// Number of evenly spaced yaw angles rendered per asset into a single sprite sheet texture, for rotating previews. 0 or 1 exports the regular thumbnail
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, meta=(ClampMin=0, ClampMax=64), Category = "Thumbnail To Texture Settings")
+	int32 TurntableFrames;
+
+	// Static meshes and blueprints are exported as octahedral impostor atlases of N x N views, the color grid above a world normal grid with the depth in alpha. 0 exports thumbnails, replaces the turntable
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, meta=(ClampMin=0, ClampMax=32), Category = "Thumbnail To Texture Settings")
+	int32 ImpostorGridSize;
+
+	// The impostor views cover the whole sphere of directions instead of the upper hemisphere, for props also seen from below
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, meta=(EditCondition="ImpostorGridSize > 0"), Category = "Thumbnail To Texture Settings")
+	bool ImpostorFullSphere;
+
+	// Number of rendered thumbnails that can be copied back from the GPU while the next ones are drawn
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta=(ClampMin=1, ClampMax=16), Category = "Thumbnail To Texture Settings")
+	int32 NumReadbacksInFlight;
+
+	// Number of idle render targets kept alive between thumbnails and export batches, extra ones free their GPU memory
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta=(ClampMin=0, ClampMax=64), Category = "Thumbnail To Texture Settings")
+	int32 MaxPooledRenderTargets;
+
+	// Size of the objects of the preview scenes kept per blueprint class and skeletal mesh, the least recently used scenes are freed above it.
+	// Only the actors and components of their worlds are counted, not the renderer's copy of each scene, so the scenes use more memory than this
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta=(ClampMin=16, ClampMax=4096), Category = "Thumbnail To Texture Settings")
+	int32 PreviewSceneCacheObjectBudgetMB;
+
+	// Number of assets of the same kind drawn together in one scene render, each in its own tile of a shared render target. 1 draws every asset on its own
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta=(ClampMin=1, ClampMax=16), Category = "Thumbnail To Texture Settings")
+	int32 MaxBatchSize;
+
+	// Store the rendered thumbnails in the Derived Data Cache and fetch them from it instead of rendering, shares the renders between machines using the same cache
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Thumbnail To Texture Settings")
+	bool UseDerivedDataCache;
+
+	// Milliseconds of each editor frame spent exporting when exporting from the Content Browser, the editor stays responsive in between
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta=(ClampMin=1, ClampMax=1000), Category = "Thumbnail To Texture Settings")
+	float ExportFrameBudgetMs;
+
+	// Longest time a render waits for the textures and meshes of its assets to be fully streamed in, in seconds. 0 renders with whatever mips are resident
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta=(ClampMin=0, ClampMax=120), Category = "Thumbnail To Texture Settings")
+	float StreamingWaitTimeoutSeconds;
+
+	// Builds the mips of the exported textures from their pixels on worker threads. Only transparent background thumbnails are weighted by alpha so the keyed pixels don't darken the small mips, the others and impostors are plainly averaged. Only for power of two sizes, the others have no mips
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Thumbnail To Texture Settings")
+	bool GenerateMipsOnCPU;
+
+	// Texture2D exports packages, the image formats write the read back pixels straight to files mirroring the content folders, encoded on worker threads without creating any texture
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, Category = "Thumbnail To Texture Settings")
+	EThumbnailOutputFormat OutputFormat;
+
+	// Root of the image files when the output format isn't Texture2D, relative to the project directory. /Game/Props/SM_Chair is written to <Directory>/Game/Props/<Prefix>SM_Chair.png
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, meta=(RelativeToGameDir, EditCondition="OutputFormat != EThumbnailOutputFormat::Texture2D"), Category = "Thumbnail To Texture Settings")
+	FDirectoryPath ImageOutputDirectory;
+
+	// The file every thumbnail is appended to when the output format is Container, relative to the project directory. Exports into an existing container add to it and replace the entries of the exported assets
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, meta=(RelativeToGameDir, FilePathFilter="ttc", EditCondition="OutputFormat == EThumbnailOutputFormat::Container"), Category = "Thumbnail To Texture Settings")
+	FFilePath ContainerFile;
+
+	// How each thumbnail is stored in the container, BGRA8 entries are read without decoding but take 4 bytes per pixel
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, meta=(EditCondition="OutputFormat == EThumbnailOutputFormat::Container"), Category = "Thumbnail To Texture Settings")
+	EThumbnailContainerEntryFormat ContainerEntryFormat;
+
 	UPROPERTY(Transient)
 	TObjectPtr<UMaterial> TranslucentMaterial;
 
 	UMaterial* GetBackgroundMaterial() const;
+
+	/** Loads TranslucentMaterial when it couldn't be found in the constructor, like when running a commandlet */
+	void LoadTranslucentMaterial();
+
+	/** Resolves the settings for an export job, the background material is loaded and its key color read on every call */
+	TSharedRef<const FThumbnailToTextureSettingsSnapshot> MakeSnapshot() const;
 };
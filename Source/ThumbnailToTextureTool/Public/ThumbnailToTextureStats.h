@@ -0,0 +1,137 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+/**
+ * Instrumentation of the export pipeline, shared by the Content Browser export and the commandlet.
+ * "stat ThumbnailToTexture" shows the time spent in each phase, and Unreal Insights shows the same phases as CPU scopes
+ * once the channel is enabled, with -trace=cpu,counters,ThumbnailToTexture or "Trace.Enable ThumbnailToTexture".
+ */
+DECLARE_STATS_GROUP(TEXT("ThumbnailToTexture"), STATGROUP_ThumbnailToTexture, STATCAT_Advanced);
+
+/** Time spent in each phase of the export */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Asset"), STAT_ThumbnailToTexture_LoadAsset, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Scene Setup"), STAT_ThumbnailToTexture_SceneSetup, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Streaming Wait"), STAT_ThumbnailToTexture_StreamingWait, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Render"), STAT_ThumbnailToTexture_Render, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Readback"), STAT_ThumbnailToTexture_Readback, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Keying"), STAT_ThumbnailToTexture_Keying, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Derived Data"), STAT_ThumbnailToTexture_DerivedData, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Cached Read"), STAT_ThumbnailToTexture_CachedRead, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Mip Generation"), STAT_ThumbnailToTexture_MipGeneration, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Texture Build"), STAT_ThumbnailToTexture_TextureBuild, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Texture Compile Wait"), STAT_ThumbnailToTexture_TextureCompileWait, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save"), STAT_ThumbnailToTexture_Save, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Image Write"), STAT_ThumbnailToTexture_ImageWrite, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+
+/** Items that went through each phase since the editor started */
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Assets Loaded"), STAT_ThumbnailToTexture_NumLoadAsset, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Scenes Set Up"), STAT_ThumbnailToTexture_NumSceneSetup, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Renders Waiting For Streaming"), STAT_ThumbnailToTexture_NumStreamingWait, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Thumbnails Rendered"), STAT_ThumbnailToTexture_NumRender, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Thumbnails Read Back"), STAT_ThumbnailToTexture_NumReadback, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Thumbnails Keyed"), STAT_ThumbnailToTexture_NumKeying, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Derived Data Hits"), STAT_ThumbnailToTexture_NumDerivedData, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Cached Thumbnails Read"), STAT_ThumbnailToTexture_NumCachedRead, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Mip Chains Built"), STAT_ThumbnailToTexture_NumMipGeneration, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Textures Built"), STAT_ThumbnailToTexture_NumTextureBuild, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Textures Waited For"), STAT_ThumbnailToTexture_NumTextureCompileWait, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Packages Saved"), STAT_ThumbnailToTexture_NumSave, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Images Written"), STAT_ThumbnailToTexture_NumImageWrite, STATGROUP_ThumbnailToTexture, THUMBNAILTOTEXTURETOOL_API);
+
+/** Same counters in Unreal Insights */
+TRACE_DECLARE_INT_COUNTER_EXTERN(ThumbnailToTexture_NumLoadAsset);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ThumbnailToTexture_NumSceneSetup);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ThumbnailToTexture_NumStreamingWait);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ThumbnailToTexture_NumRender);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ThumbnailToTexture_NumReadback);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ThumbnailToTexture_NumKeying);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ThumbnailToTexture_NumDerivedData);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ThumbnailToTexture_NumCachedRead);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ThumbnailToTexture_NumMipGeneration);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ThumbnailToTexture_NumTextureBuild);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ThumbnailToTexture_NumTextureCompileWait);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ThumbnailToTexture_NumSave);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ThumbnailToTexture_NumImageWrite);
+
+UE_TRACE_CHANNEL_EXTERN(ThumbnailToTextureChannel, THUMBNAILTOTEXTURETOOL_API);
+
+/** The same phases, also timed when the stat group isn't enabled so tools can read them, see ThumbnailToTextureStats::GetPhaseTotals() */
+enum class EThumbnailExportPhase : uint8
+{
+	LoadAsset,
+	SceneSetup,
+	StreamingWait,
+	Render,
+	Readback,
+	Keying,
+	DerivedData,
+	CachedRead,
+	MipGeneration,
+	TextureBuild,
+	TextureCompileWait,
+	Save,
+	ImageWrite,
+	Num
+};
+
+/**
+ * Time spent in and items counted through each phase since the editor started, on every thread.
+ * The totals of a run are the difference of the totals after and before it
+ */
+struct THUMBNAILTOTEXTURETOOL_API FThumbnailExportPhaseTotals
+{
+	double Seconds[static_cast<int32>(EThumbnailExportPhase::Num)] = {};
+	int64 NumItems[static_cast<int32>(EThumbnailExportPhase::Num)] = {};
+
+	FThumbnailExportPhaseTotals operator-(const FThumbnailExportPhaseTotals& Other) const;
+};
+
+namespace ThumbnailToTextureStats
+{
+	/** @return name of the phase, the one of its enum value */
+	THUMBNAILTOTEXTURETOOL_API const TCHAR* GetPhaseName(EThumbnailExportPhase Phase);
+
+	THUMBNAILTOTEXTURETOOL_API void AddPhaseCycles(EThumbnailExportPhase Phase, uint64 Cycles);
+	THUMBNAILTOTEXTURETOOL_API void AddPhaseItems(EThumbnailExportPhase Phase, int64 NumItems);
+
+	THUMBNAILTOTEXTURETOOL_API FThumbnailExportPhaseTotals GetPhaseTotals();
+
+	/** Adds the time until the end of the scope to a phase */
+	class FPhaseScope
+	{
+	public:
+		explicit FPhaseScope(EThumbnailExportPhase InPhase)
+			: Phase(InPhase)
+			, StartCycles(FPlatformTime::Cycles64())
+		{
+		}
+
+		~FPhaseScope()
+		{
+			AddPhaseCycles(Phase, FPlatformTime::Cycles64() - StartCycles);
+		}
+
+	private:
+		EThumbnailExportPhase Phase;
+		uint64 StartCycles;
+	};
+}
+
+/** Times the rest of the scope as the given phase, in the stat group and on the trace channel */
+#define THUMBNAILTOTEXTURE_SCOPE(Phase) \
+	SCOPE_CYCLE_COUNTER(STAT_ThumbnailToTexture_##Phase); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(ThumbnailToTexture_##Phase, ThumbnailToTextureChannel); \
+	const ThumbnailToTextureStats::FPhaseScope ThumbnailToTexturePhaseScope_##Phase(EThumbnailExportPhase::Phase)
+
+/** Counts Amount items through the given phase */
+#define THUMBNAILTOTEXTURE_COUNT(Phase, Amount) \
+	INC_DWORD_STAT_BY(STAT_ThumbnailToTexture_Num##Phase, Amount); \
+	TRACE_COUNTER_ADD(ThumbnailToTexture_Num##Phase, Amount); \
+	ThumbnailToTextureStats::AddPhaseItems(EThumbnailExportPhase::Phase, Amount)
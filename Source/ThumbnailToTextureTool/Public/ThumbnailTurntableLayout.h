@@ -0,0 +1,42 @@
+// Credits please, open source from NanceDevDiaries. Game on!
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UTexture2D;
+
+/**
+ * Frames of a turntable sprite sheet, the same asset seen from evenly spaced yaw angles around its thumbnail orbit.
+ * Frame 0 is the regular thumbnail view, the frames are laid out left to right then top to bottom on a grid as square as possible.
+ * A single frame is the regular thumbnail.
+ */
+struct THUMBNAILTOTEXTURETOOL_API FThumbnailTurntableLayout
+{
+	FThumbnailTurntableLayout() = default;
+	explicit FThumbnailTurntableLayout(int32 InNumFrames);
+
+	int32 NumFrames = 1;
+	int32 NumColumns = 1;
+	int32 NumRows = 1;
+
+	bool IsTurntable() const { return NumFrames > 1; }
+
+	/** @return size of the whole sheet when each frame is FrameSize */
+	FIntPoint GetSheetSize(FIntPoint FrameSize) const { return FIntPoint(FrameSize.X * NumColumns, FrameSize.Y * NumRows); }
+
+	/** @return area of a frame within a sheet drawn at SheetRect, whose size is a multiple of the grid */
+	FIntRect GetFrameRect(const FIntRect& SheetRect, int32 FrameIndex) const;
+
+	/** @return yaw added to the thumbnail orbit for a frame, in degrees */
+	float GetFrameYaw(int32 FrameIndex) const { return 360.f * FrameIndex / NumFrames; }
+
+	/**
+	 * Records the layout on a sprite sheet texture as a UThumbnailTurntableUserData, read back with ReadFromTexture().
+	 * The user data is cooked with the texture, so games can read it at runtime through the ThumbnailToTextureRuntime module.
+	 */
+	void WriteToTexture(UTexture2D* Texture) const;
+
+	/** @return false if the texture has no turntable layout, OutLayout is then a single frame */
+	static bool ReadFromTexture(const UTexture2D* Texture, FThumbnailTurntableLayout& OutLayout);
+};
@@ -27,7 +27,8 @@ public class ThumbnailToTextureTool : ModuleRules
 			{
 				"Core",
 				"RenderCore",
-				"RHI", "UnrealEd", "UnrealEd", "UMG"
+				"RHI", "UnrealEd", "UnrealEd", "UMG",
+				"ThumbnailToTextureRuntime"
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
@@ -37,9 +38,17 @@ public class ThumbnailToTextureTool : ModuleRules
 			new string[]
 			{
 				"CoreUObject",
+				"DerivedDataCache",
 				"Engine",
+				"ImageCore",
+				"ImageWrapper",
+				"Json",
+				"MeshDescription",
+				"Projects",
 				"Slate",
 				"SlateCore",
+				"SourceControl",
+				"StaticMeshDescription",
 				"UnrealEd",
 				// ... add private dependencies that you statically link with here ...	
 			}